@@ -0,0 +1,204 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "analyze.h"
+#include "array.h"
+#include "compiler.h"
+#include "module.h"
+#include "pool.h"
+#include "project.h"
+#include "table.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ONES  0x0101010101010101ULL
+#define HIGHS 0x8080808080808080ULL
+
+// Little-endian load, so byte i is always bits 8i..8i+7
+static uint64_t load64(const unsigned char *p) {
+    uint64_t x = 0;
+    for (int i = 7; i >= 0; i--) x = x << 8 | p[i];
+    return x;
+}
+
+// High bit of every byte that belongs to a word (> ' ', UTF-8 bytes included)
+static uint64_t word_bytes(const uint64_t x) {
+    return (((x & ~HIGHS) + (0x7F - 0x20) * ONES) | x) & HIGHS;
+}
+
+// Number of bytes with the high bit set in a HIGHS-masked value
+static long count_highs(const uint64_t x) {
+    return (long) (((x >> 7) * ONES) >> 56);
+}
+
+void count_line(const char *text, const size_t len, Counts *counts) {
+    const unsigned char *s = (const unsigned char *) text;
+    uint64_t prev = 0;      // Word flag of the byte before the chunk, in bit 7
+    long words = 0, continuation = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= len; i += 8) {
+        const uint64_t x = load64(s + i);
+        const uint64_t w = word_bytes(x);
+
+        // A word starts where a word byte follows a non-word byte
+        words += count_highs(w & ~(w << 8 | prev));
+        prev = w >> 56;
+
+        // UTF-8 continuation bytes (10xxxxxx) are not characters
+        continuation += count_highs(x & ~(x << 1) & HIGHS);
+    }
+
+    int in_word = (prev & 0x80) != 0;
+    for (; i < len; i++) {
+        const int w = s[i] > ' ';
+        if (w && !in_word) words++;
+        in_word = w;
+        if ((s[i] & 0xC0) == 0x80) continuation++;
+    }
+
+    counts->lines++;
+    counts->words += words;
+    counts->chars += (long) len - continuation;
+}
+
+static void add_counts(Counts *to, const Counts *c) {
+    to->lines += c->lines;
+    to->words += c->words;
+    to->chars += c->chars;
+}
+
+// Counts keyed by speaker name
+typedef struct {
+    Table names;
+    Counts *counts;     // By name index
+    int cap;
+} SpeakerCounts;
+
+static Counts *speaker_counts(SpeakerCounts *sc, const char *name) {
+    int added;
+    const int i = table_intern(&sc->names, name, strlen(name), &added);
+    if (i < 0) return NULL;
+    if (added) {
+        // Names are dense, so a new name is always the next entry
+        if (!array_grow((void **) &sc->counts, &sc->cap, i, sizeof(Counts))) return NULL;
+        memset(&sc->counts[i], 0, sizeof(Counts));
+    }
+    return &sc->counts[i];
+}
+
+static void speaker_counts_free(SpeakerCounts *sc) {
+    table_free(&sc->names);
+    free(sc->counts);
+}
+
+// Dialog block counts
+typedef struct {
+    int number;
+    Counts counts;
+} DialogCounts;
+
+// Stats of one file (one scene), filled by analyze_line()
+typedef struct {
+    int scene;
+    Counts total;
+    SpeakerCounts speakers;
+    DialogCounts *dialogs;
+    int dialog_count, dialog_cap;
+} SceneStats;
+
+// DialogHook: count one line
+static void analyze_line(const DialogLine *line, void *ctx) {
+    SceneStats *st = ctx;
+    Counts c = {0, 0, 0};
+    count_line(line->text, strlen(line->text), &c);
+
+    st->scene = line->scene;
+    add_counts(&st->total, &c);
+
+    Counts *speaker = speaker_counts(&st->speakers, line->name);
+    if (speaker) add_counts(speaker, &c);
+
+    // Lines arrive in order, so a new dialog number starts a new block
+    if (!st->dialog_count || st->dialogs[st->dialog_count - 1].number != line->dialog) {
+        if (!array_grow((void **) &st->dialogs, &st->dialog_cap, st->dialog_count, sizeof(DialogCounts))) return;
+        st->dialogs[st->dialog_count].number = line->dialog;
+        memset(&st->dialogs[st->dialog_count].counts, 0, sizeof(Counts));
+        st->dialog_count++;
+    }
+    add_counts(&st->dialogs[st->dialog_count - 1].counts, &c);
+}
+
+static void report_row(Output *out, const char *indent, const char *label, const Counts *c) {
+    out_printf(out, "%s%-*s %8ld %10ld %12ld\n", indent, 32 - (int) strlen(indent), label, c->lines, c->words,
+               c->chars);
+}
+
+static void report_speakers(Output *out, const SpeakerCounts *sc) {
+    for (int i = 0; i < sc->names.count; i++)
+        report_row(out, "    ", table_key(&sc->names, i), &sc->counts[i]);
+}
+
+int analyze_files(const char *const *files, const int count, const int jobs, const int verbose) {
+    Output out;
+    out_init_file(&out, stdout);
+
+    ModuleCache *modules = module_cache_new();
+    SceneStats *stats = calloc((size_t) count, sizeof(SceneStats));
+    if (!stats) {
+        fprintf(stderr, "\033[1;31mError:\033[0m out of memory\n");
+        module_cache_free(modules);
+        out_free(&out);
+        return 1;
+    }
+
+    // Count phase: each file fills its own stats, diagnostics come first
+    const int threads = jobs > 0 ? jobs : pool_cpu_count();
+    const BatchOptions batch = {verbose, threads, modules, NULL, analyze_line, stats, sizeof(SceneStats)};
+    const int error = compile_batch(files, count, &batch, &out);
+
+    // Per scene: dialogs, speakers and total; merge speakers into the project
+    SpeakerCounts project;
+    memset(&project, 0, sizeof(project));
+    table_init(&project.names);
+    Counts total = {0, 0, 0};
+    char label[64];
+
+    out_printf(&out, "\033[1;37m%-32s %8s %10s %12s\033[0m\n", "Analysis", "Lines", "Words", "Chars");
+    for (int i = 0; i < count; i++) {
+        const SceneStats *st = &stats[i];
+        if (!st->total.lines) continue;
+
+        out_printf(&out, "\033[1;36m◉ Scene %d\033[0m \033[90m%s\033[0m\n", st->scene, files[i]);
+        for (int d = 0; d < st->dialog_count; d++) {
+            snprintf(label, sizeof(label), "Dialog %d", st->dialogs[d].number);
+            report_row(&out, "  ", label, &st->dialogs[d].counts);
+        }
+        report_speakers(&out, &st->speakers);
+        report_row(&out, "  ", "Total", &st->total);
+
+        for (int s = 0; s < st->speakers.names.count; s++) {
+            Counts *c = speaker_counts(&project, table_key(&st->speakers.names, s));
+            if (c) add_counts(c, &st->speakers.counts[s]);
+        }
+        add_counts(&total, &st->total);
+    }
+
+    out_printf(&out, "\033[1;36mProject\033[0m \033[90m%d files\033[0m\n", count);
+    report_speakers(&out, &project);
+    report_row(&out, "  ", "Total", &total);
+
+    speaker_counts_free(&project);
+    for (int i = 0; i < count; i++) {
+        speaker_counts_free(&stats[i].speakers);
+        free(stats[i].dialogs);
+    }
+    free(stats);
+    module_cache_free(modules);
+    out_free(&out);
+    return error;
+}
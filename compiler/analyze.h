@@ -0,0 +1,21 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+// Line, word and character (UTF-8 code point) counts
+typedef struct {
+    long lines;
+    long words;
+    long chars;
+} Counts;
+
+// Add one line of text: words are runs of non-whitespace, counted 8 bytes at a time
+void count_line(const char *text, size_t len, Counts *counts);
+
+// Compile files in parallel and report per-speaker, per-dialog, per-scene and project counts.
+// Returns the error count
+int analyze_files(const char *const *files, int count, int jobs, int verbose);
@@ -0,0 +1,17 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "array.h"
+
+#include <stdlib.h>
+
+int array_grow(void **items, int *cap, const int count, const size_t size) {
+    if (count < *cap) return 1;
+    const int n = *cap ? *cap * 2 : 8;
+    void *p = realloc(*items, (size_t) n * size);
+    if (!p) return 0;
+    *items = p;
+    *cap = n;
+    return 1;
+}
@@ -0,0 +1,11 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+// Make room for one more element in a growable array of count elements of the given size.
+// Capacity doubles (starting at 8). Returns 0 if out of memory (the array is left as is)
+int array_grow(void **items, int *cap, int count, size_t size);
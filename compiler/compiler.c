@@ -3,94 +3,256 @@
 // See: http://www.apache.org/licenses/LICENSE-2.0
 
 #include "compiler.h"
+#include "array.h"
 #include "parser.h"
 #include "verbose.h"
+#include "link.h"
+#include "module.h"
+#include "table.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
 // Helper functions
-static void report_error_at(const int verbose, const int line, const char *msg, const char *hint, const char *line_content,
-                            const int pos) {
-    if (verbose) verbose_error(line, msg, hint, line_content, pos);
-    else brief_error(line, msg, hint, line_content, pos);
+static void report_error_at(Output *out, const int verbose, const int line, const char *msg, const char *hint,
+                            const char *line_content, const int pos) {
+    if (verbose) verbose_error(out, line, msg, hint, line_content, pos);
+    else brief_error(out, line, msg, hint, line_content, pos);
 }
 
-// Check if character name is in the known list
-static int char_known(const char *name, const char *list) {
-    char buf[1024];
-    strncpy(buf, list, sizeof(buf)-1);
-    buf[sizeof(buf) - 1] = '\0';
-
-    char *t = strtok(buf, ",");
-    while (t) {
-        while (isspace(*t)) t++;
-        char *end = t + strlen(t) - 1;
-        while (end >= t && isspace(*end)) *end-- = '\0';
-        if (strcmp(t, name) == 0) return 1;
-        t = strtok(NULL, ",");
+// Add names from a Characters list to the known set (and to the symbols)
+static void add_characters(Table *known, Symbols *symbols, const char *list, const int line_num) {
+    const char *name;
+    size_t len;
+    for (const char *s = list; (s = next_name(s, &name, &len));) {
+        int added;
+        table_intern(known, name, len, &added);
+        if (added && symbols) symbols_add_name(symbols, name, len, line_num);
     }
-    return 0;
 }
 
-// Main compile function
-char compile(const char *filename, const int verbose) {
-    char path[1024];
-    snprintf(path, sizeof(path), "%s", filename);
+// Import state passed to apply_import()
+typedef struct {
+    Output *out;
+    int verbose;
+    int line_num;               // Line of the Import directive
+    const char *line_content;
+    Table *characters;
+    Symbols *symbols;
+    int has_level;              // Set by any imported module
+    int has_location;
+    int has_chars;
+    int error;
+} Import;
+
+// {Goto: ...} to a dialog of the file's own scene not declared yet, an error if it never is
+typedef struct {
+    int dialog;
+    int line;
+    int pos;
+    char *content;      // Copy of the line, for the error
+} LocalGoto;
+
+// Where compile_lines() reads from: a stream or an in-memory source
+typedef struct {
+    FILE *file;         // NULL for a buffer
+    const char *src;
+    size_t len;
+    size_t pos;
+} LineSource;
+
+// Make a line buffer hold at least need bytes
+static int reserve_line(char **buf, size_t *cap, const size_t need) {
+    if (need <= *cap) return 1;
+    size_t n = *cap ? *cap : 256;
+    while (n < need) n *= 2;
+    char *grown = realloc(*buf, n);
+    if (!grown) return 0;
+    *buf = grown;
+    *cap = n;
+    return 1;
+}
 
-    FILE *f = fopen(path, "r");
-    if (!f) {
-        fprintf(stderr, "\033[1;31mError:\033[0m cannot open file %s. Does it exist?\n", path);
+// Read the next line (without its '\n') into buf, return 0 at the end
+static int read_line(LineSource *s, char **buf, size_t *cap) {
+    if (!s->file) {
+        if (s->pos >= s->len) return 0;
+        const char *start = s->src + s->pos;
+        const char *nl = memchr(start, '\n', s->len - s->pos);
+        const size_t n = nl ? (size_t) (nl - start) : s->len - s->pos;
+        if (!reserve_line(buf, cap, n + 1)) return 0;
+        memcpy(*buf, start, n);
+        (*buf)[n] = '\0';
+        s->pos += n + 1;
         return 1;
     }
 
-    char lines[1024][1024];
-    char original_lines[1024][1024];
-    int total_lines = 0;
+    // Like the fgets() loop, but a long line grows the buffer instead of being split
+    size_t n = 0;
+    for (;;) {
+        if (!reserve_line(buf, cap, n + 2)) return 0;
+        if (!fgets(*buf + n, (int) (*cap - n), s->file)) break;
+        n += strlen(*buf + n);
+        if (n && (*buf)[n - 1] == '\n') {
+            (*buf)[n - 1] = '\0';
+            return 1;
+        }
+    }
+    return n > 0;
+}
+
+static int compile_lines(const char *path, LineSource *source, const CompileOptions *opt);
 
-    memset(lines, 0, sizeof(lines));
-    memset(original_lines, 0, sizeof(original_lines));
+// Merge one imported module into the unit
+static void apply_import(const Module *m, void *ctx) {
+    Import *imp = ctx;
 
-    while (fgets(lines[total_lines], 1024, f)) {
-        lines[total_lines][strcspn(lines[total_lines], "\n")] = '\0';
-        strcpy(original_lines[total_lines], lines[total_lines]);
-        total_lines++;
+    for (int i = 0; i < m->error_count; i++) {
+        const ModuleError *e = &m->errors[i];
+        char msg[1280];
+        if (e->line) snprintf(msg, sizeof(msg), "%s (%s:%d)", e->message, m->path, e->line);
+        else snprintf(msg, sizeof(msg), "%s (%s)", e->message, m->path);
+        report_error_at(imp->out, imp->verbose, imp->line_num, msg, e->hint,
+                        e->content ? e->content : imp->line_content, 0);
+        imp->error++;
+    }
+
+    for (int i = 0; i < m->name_count; i++) {
+        int added;
+        table_intern(imp->characters, m->names[i], strlen(m->names[i]), &added);
+        if (added && imp->symbols) symbols_add_name(imp->symbols, m->names[i], strlen(m->names[i]), imp->line_num);
+    }
+    if (m->name_count) imp->has_chars = 1;
+    if (m->level) imp->has_level = 1;
+    if (m->location) imp->has_location = 1;
+}
+
+// Read a whole file into memory
+char *read_source(const char *filename, size_t *len) {
+    FILE *f = fopen(filename, "r");
+    if (!f) return NULL;
+
+    size_t cap = 64 * 1024, n = 0, got;
+    char *buf = malloc(cap + 1);
+
+    while (buf && (got = fread(buf + n, 1, cap - n, f)) > 0) {
+        n += got;
+        if (n == cap) {
+            char *grown = realloc(buf, cap * 2 + 1);
+            if (!grown) {
+                free(buf);
+                buf = NULL;
+                break;
+            }
+            buf = grown;
+            cap *= 2;
+        }
     }
 
     fclose(f);
-    if (verbose) verbose_header(path);
+    if (!buf) return NULL;
+    buf[n] = '\0';
+    *len = n;
+    return buf;
+}
+
+int compile_unit(const char *filename, const CompileOptions *opt) {
+    FILE *f = fopen(filename, "r");
+    if (!f) {
+        if (opt->verbose) verbose_header(opt->out, filename);
+        out_printf(opt->out, "\033[1;31mError:\033[0m cannot open file %s. Does it exist?\n", filename);
+        return 1;
+    }
+
+    // Lines stream from the file, so memory does not grow with its size
+    LineSource source = {f, NULL, 0, 0};
+    const int error = compile_lines(filename, &source, opt);
+    fclose(f);
+    return error;
+}
+
+// Main compile function
+char compile(const char *filename, const int verbose) {
+    Output out;
+    out_init_file(&out, stdout);
+
+    const CompileOptions opt = {verbose, &out, NULL, NULL, NULL, NULL};
+    const int error = compile_unit(filename, &opt);
+
+    out_free(&out);
+    return (char) error;
+}
+
+int compile_source(const char *path, const char *src, const size_t len, const CompileOptions *opt) {
+    LineSource source = {NULL, src, len, 0};
+    return compile_lines(path, &source, opt);
+}
+
+static int compile_lines(const char *path, LineSource *source, const CompileOptions *opt) {
+    Output *out = opt->out;
+    const int verbose = opt->verbose;
+    Symbols *symbols = opt->symbols;
+    ModuleCache *modules = opt->modules;
+    ModuleCache *own_modules = NULL;
+
+    // One line of lookahead: parse_line() works on a scratch copy, errors show the original
+    char *line = NULL, *next = NULL, *scratch = NULL, *peek = NULL;
+    size_t line_cap = 0, next_cap = 0, scratch_cap = 0, peek_cap = 0;
+    int total_lines = 0;
+
+    if (verbose) verbose_header(out, path);
 
     int error = 0;
-    int scene = 0, dialog = 0;
-    char characters[1024] = {0};
+    int scene = 0, dialog = 0, dialog_num = 0;
+    Table characters, speakers, dialogs;
+    table_init(&characters);
+    table_init(&speakers);
+    table_init(&dialogs);
+    LocalGoto *gotos = NULL;
+    int goto_count = 0, goto_cap = 0;
+    char key[16];
 
     int has_scene = 0, has_level = 0, has_location = 0, has_chars = 0;
+    Import imported = {out, verbose, 0, NULL, &characters, symbols, 0, 0, 0, 0};
 
     // Define error reporting macros
-#define fail(msg, hint)         do { report_error_at(verbose, line_num, msg, hint, original_lines[i], 0); error++; } while(0)
-#define fail_at(msg, hint, pos) do { report_error_at(verbose, line_num, msg, hint, original_lines[i], pos); error++; } while(0)
-#define fail_final(msg, hint)   do { report_error_at(verbose, total_lines, msg, hint, NULL, 0); error++; } while(0)
+#define fail(msg, hint)         do { report_error_at(out, verbose, line_num, msg, hint, line, 0); error++; } while(0)
+#define fail_at(msg, hint, pos) do { report_error_at(out, verbose, line_num, msg, hint, line, pos); error++; } while(0)
+#define fail_final(msg, hint)   do { report_error_at(out, verbose, total_lines, msg, hint, NULL, 0); error++; } while(0)
 
     // Parse each line
-    for (int i = 0; i < total_lines; i++) {
-        const int line_num = i + 1;
-        ParsedLine p = parse_line(lines[i]);
+    int has_next = read_line(source, &next, &next_cap);
+    while (has_next) {
+        char *swap = line;
+        const size_t swap_cap = line_cap;
+        line = next;
+        line_cap = next_cap;
+        next = swap;
+        next_cap = swap_cap;
+        has_next = read_line(source, &next, &next_cap);
+
+        const int line_num = ++total_lines;
+        const size_t line_len = strlen(line);
+        if (!reserve_line(&scratch, &scratch_cap, line_len + 1)) break;
+        memcpy(scratch, line, line_len + 1);
+        ParsedLine p = parse_line(scratch);
 
         switch (p.type) {
             case LINE_EMPTY:
-                if (dialog && i + 1 < total_lines) {
-                    ParsedLine next = parse_line(lines[i + 1]);
-                    const int bad = next.type != LINE_DIALOG_HEADER && next.type != LINE_COMMENT;
-                    free_parsed_line(&next);
+                if (dialog && has_next && reserve_line(&peek, &peek_cap, strlen(next) + 1)) {
+                    strcpy(peek, next);
+                    ParsedLine following = parse_line(peek);
+                    const int bad = following.type != LINE_DIALOG_HEADER && following.type != LINE_COMMENT;
+                    free_parsed_line(&following);
                     if (bad)
                         fail("Empty line inside dialog block", "remove empty lines between dialog lines");
                 }
-                if (verbose) verbose_empty_line(line_num);
+                if (verbose) verbose_empty_line(out, line_num);
                 break;
 
             case LINE_COMMENT:
-                if (verbose) verbose_comment(line_num, p.value);
+                if (verbose) verbose_comment(out, line_num, p.value);
                 break;
 
             case LINE_SCENE:
@@ -101,9 +263,12 @@ char compile(const char *filename, const int verbose) {
                 else {
                     scene = p.number;
                     dialog = 0;
-                    characters[0] = '\0';
                     has_scene = 1;
-                    if (verbose) verbose_scene(line_num, p.number);
+                    if (symbols) {
+                        symbols->scene = p.number;
+                        symbols->scene_line = line_num;
+                    }
+                    if (verbose) verbose_scene(out, line_num, p.number);
                 }
                 break;
 
@@ -114,7 +279,25 @@ char compile(const char *filename, const int verbose) {
                     fail_at("Dialog number must be > 0", "use [Dialog.1], [Dialog.2], etc.", 8);
                 else {
                     dialog = 1;
-                    if (verbose) verbose_dialog(line_num, p.number);
+                    dialog_num = p.number;
+
+                    int added;
+                    const int key_len = snprintf(key, sizeof(key), "%d", p.number);
+                    table_intern(&dialogs, key, (size_t) key_len, &added);
+                    if (!added)
+                        fail("Duplicate [Dialog.N] in scene", "renumber this dialog block");
+                    else {
+                        if (symbols) symbols_add_dialog(symbols, p.number, line_num);
+
+                        // Gotos waiting for this dialog are resolved
+                        int kept = 0;
+                        for (int g = 0; g < goto_count; g++) {
+                            if (gotos[g].dialog == p.number) free(gotos[g].content);
+                            else gotos[kept++] = gotos[g];
+                        }
+                        goto_count = kept;
+                    }
+                    if (verbose) verbose_dialog(out, line_num, p.number);
                 }
                 break;
 
@@ -127,7 +310,7 @@ char compile(const char *filename, const int verbose) {
                     fail("Duplicate Level", "remove extra Level definition");
                 else {
                     has_level = 1;
-                    if (verbose) verbose_level(line_num, p.value);
+                    if (verbose) verbose_level(out, line_num, p.value);
                 }
                 break;
 
@@ -140,7 +323,7 @@ char compile(const char *filename, const int verbose) {
                     fail("Duplicate Location", "remove extra Location definition");
                 else {
                     has_location = 1;
-                    if (verbose) verbose_location(line_num, p.value);
+                    if (verbose) verbose_location(out, line_num, p.value);
                 }
                 break;
 
@@ -152,26 +335,84 @@ char compile(const char *filename, const int verbose) {
                 else if (has_chars)
                     fail("Duplicate Characters", "remove extra Characters definition");
                 else {
-                    strncpy(characters, p.value, 1023);
+                    add_characters(&characters, symbols, p.value, line_num);
                     has_chars = 1;
-                    if (verbose) verbose_characters(line_num, p.value);
+                    if (verbose) verbose_characters(out, line_num, p.value);
+                }
+                break;
+
+            case LINE_IMPORT:
+                if (!scene)
+                    fail("Import outside scene", "move Import: x inside [Scene.X] block");
+                else if (dialog)
+                    fail("Import after dialog", "move Import: x before [Dialog.X]");
+                else if (!p.value[0])
+                    fail("Empty Import path", "use 'Import: file.ds'");
+                else {
+                    if (!modules) modules = own_modules = module_cache_new();
+                    if (!modules) break;
+
+                    char target[1024], cycle[1024];
+                    module_resolve_path(target, sizeof(target), path, p.value);
+                    imported.line_num = line_num;
+                    imported.line_content = line;
+                    if (module_walk(modules, path, target, apply_import, &imported, cycle, sizeof(cycle)) < 0)
+                        fail("Import cycle", cycle);
+                    if (verbose) verbose_import(out, line_num, p.value);
                 }
                 break;
 
-            case LINE_DIALOG:
+            case LINE_DIALOG: {
                 if (!dialog) {
                     fail("Stray dialog line", "add [Dialog.1] before this line");
                     break;
                 }
 
-                if (characters[0] && !char_known(p.name, characters))
+                const int errors_before = error;
+
+                if (characters.count && table_find(&characters, p.name, strlen(p.name)) < 0)
                     fail("Unknown character", "add this character to Characters");
+                else if (!characters.count && symbols) {
+                    // Nothing declared: the link step checks speakers instead
+                    int added;
+                    table_intern(&speakers, p.name, strlen(p.name), &added);
+                    if (added) symbols_add_name(symbols, p.name, strlen(p.name), line_num);
+                }
 
                 if (p.meta && !strchr(p.meta, '}'))
-                    fail_at("Missing '}' in metadata", "close metadata with '}'", (int)(p.meta - lines[i]));
+                    fail_at("Missing '}' in metadata", "close metadata with '}'", (int)(p.meta - scratch));
+
+                if (p.meta) {
+                    int ref_scene, ref_dialog;
+                    const int ref = parse_goto(p.meta, &ref_scene, &ref_dialog);
+                    if (ref < 0)
+                        fail_at("Wrong Goto format", "use {Goto: Dialog.N} or {Goto: Scene.N/Dialog.N}",
+                                (int)(p.meta - scratch));
+                    else if (ref > 0 && ref_dialog && (!ref_scene || ref_scene == scene)) {
+                        // Same scene: wait for a dialog declared later
+                        const int key_len = snprintf(key, sizeof(key), "%d", ref_dialog);
+                        if (table_find(&dialogs, key, (size_t) key_len) < 0 &&
+                            array_grow((void **) &gotos, &goto_cap, goto_count, sizeof(LocalGoto))) {
+                            LocalGoto *g = &gotos[goto_count];
+                            g->dialog = ref_dialog;
+                            g->line = line_num;
+                            g->pos = (int)(p.meta - scratch);
+                            g->content = malloc(line_len + 1);
+                            if (g->content) memcpy(g->content, line, line_len + 1);
+                            goto_count++;
+                        }
+                    } else if (ref > 0 && ref_scene != scene && symbols)
+                        symbols_add_ref(symbols, ref_scene, ref_dialog, line_num);
+                }
 
-                if (verbose) verbose_dialog_line(line_num, p.name, p.text, p.meta);
+                if (opt->on_dialog && error == errors_before) {
+                    const DialogLine dl = {path, scene, dialog_num, line_num, p.name, p.text, p.meta};
+                    opt->on_dialog(&dl, opt->hook_ctx);
+                }
+
+                if (verbose) verbose_dialog_line(out, line_num, p.name, p.text, p.meta);
                 break;
+            }
 
             // Errors
             case LINE_ERROR_EMPTY_NAME: fail("Empty name before ':'", "add character name, e.g. Alan: Hello");
@@ -192,7 +433,9 @@ char compile(const char *filename, const int verbose) {
                 break;
             case LINE_ERROR_TYPO_CHARACTERS: fail("Did you mean 'Characters:'?", "check spelling");
                 break;
-            case LINE_ERROR_UNCLOSED_BRACKET: fail_at("Missing ']'", "close header with ']'", (int)strlen(lines[i]));
+            case LINE_ERROR_TYPO_IMPORT: fail("Did you mean 'Import:'?", "check spelling");
+                break;
+            case LINE_ERROR_UNCLOSED_BRACKET: fail_at("Missing ']'", "close header with ']'", (int)strlen(scratch));
                 break;
             case LINE_ERROR_EXTRA_SPACE_IN_HEADER: fail("Extra space in header",
                                                         "use [Scene.1] or [Dialog.1] without spaces");
@@ -217,14 +460,25 @@ char compile(const char *filename, const int verbose) {
         free_parsed_line(&p);
     }
 
-    // Final checks (missing of required parts)
+    error += imported.error;
+
+    // Gotos still waiting point at dialogs this scene never declares
+    for (int g = 0; g < goto_count; g++) {
+        char hint[64];
+        snprintf(hint, sizeof(hint), "[Scene.%d] has no [Dialog.%d]", scene, gotos[g].dialog);
+        report_error_at(out, verbose, gotos[g].line, "Unresolved Goto target", hint,
+                        gotos[g].content, gotos[g].pos);
+        error++;
+    }
+
+    // Final checks (missing of required parts, imports may provide them)
     if (!has_scene)
         fail_final("Missing [Scene.X]", "add [Scene.1] at the beginning of file");
-    if (!has_level)
+    if (!has_level && !imported.has_level)
         fail_final("Missing Level", "add 'Level: N' after [Scene.X]");
-    if (!has_location)
+    if (!has_location && !imported.has_location)
         fail_final("Missing Location", "add 'Location: name' after [Scene.X]");
-    if (!has_chars)
+    if (!has_chars && !imported.has_chars)
         fail_final("Missing Characters", "add 'Characters: Name1, Name2' after [Scene.X]");
 
 // Undefine error reporting macros
@@ -233,11 +487,22 @@ char compile(const char *filename, const int verbose) {
 #undef fail_final
 
     // Final verbose output
-    if (verbose) verbose_footer(total_lines, error);
-    else brief_result(total_lines, error);
+    if (verbose) verbose_footer(out, total_lines, error);
+    else brief_result(out, total_lines, error);
+
+    table_free(&characters);
+    table_free(&speakers);
+    table_free(&dialogs);
+    for (int g = 0; g < goto_count; g++) free(gotos[g].content);
+    free(gotos);
+    module_cache_free(own_modules);
+    free(line);
+    free(next);
+    free(scratch);
+    free(peek);
 
     // Return status
-    return (char) error;
+    return error;
 }
 
 void print_result(const char result) { (void) result; }
@@ -4,9 +4,46 @@
 
 #pragma once
 
+#include "output.h"
+
+#include <stddef.h>
+
 // Compiler modes
 #define MODE_QUIET   0    // No verbose logs
 #define MODE_VERBOSE 1    // Log each line and its evaluation
 
+// Dialog line without a line-local error, passed to the dialog hook as compile() goes.
+// File-level problems found later (unresolved Goto, duplicate [Dialog.N] block) don't hold it back
+typedef struct {
+    const char *path;
+    int scene;
+    int dialog;
+    int line;
+    const char *name;
+    const char *text;
+    const char *meta;       // Metadata block {..}, NULL if none
+} DialogLine;
+
+typedef void (*DialogHook)(const DialogLine *line, void *ctx);
+
+// Compile settings
+typedef struct {
+    int verbose;                    // MODE_QUIET or MODE_VERBOSE
+    Output *out;                    // Diagnostics sink
+    struct Symbols *symbols;        // Filled for the link step, may be NULL
+    struct ModuleCache *modules;    // Shared import cache, NULL for a private one
+    DialogHook on_dialog;           // Called for every dialog line without a line-local error, may be NULL
+    void *hook_ctx;
+} CompileOptions;
+
 char compile(const char *filename, int verbose);    // Main compile function
 void print_result(char result);                     // Print final result
+
+// Read a whole file into memory (NUL-terminated, caller frees), NULL on failure
+char *read_source(const char *filename, size_t *len);
+
+// Compile a file, return the error count
+int compile_unit(const char *filename, const CompileOptions *opt);
+
+// Compile an in-memory source, path is only used for diagnostics
+int compile_source(const char *path, const char *src, size_t len, const CompileOptions *opt);
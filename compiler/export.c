@@ -0,0 +1,147 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "export.h"
+#include "link.h"
+#include "module.h"
+#include "project.h"
+#include "table.h"
+#include "verbose.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int export_format(const char *name, ExportFormat *format) {
+    if (strcmp(name, "json") == 0) *format = EXPORT_JSON;
+    else if (strcmp(name, "ndjson") == 0) *format = EXPORT_NDJSON;
+    else if (strcmp(name, "csv") == 0) *format = EXPORT_CSV;
+    else return 0;
+    return 1;
+}
+
+void export_begin(Exporter *e, Output *out, const ExportFormat format) {
+    e->out = out;
+    e->format = format;
+    e->records = 0;
+
+    if (format == EXPORT_JSON) out_write(out, "[", 1);
+    else if (format == EXPORT_CSV) out_write(out, "file,scene,dialog,line,speaker,text,meta\n", 41);
+}
+
+// Write a JSON object key and its integer value
+static void json_int(Output *out, const char *key, const long value) {
+    out_write(out, key, strlen(key));
+    out_int(out, value);
+}
+
+void export_line(const DialogLine *line, void *ctx) {
+    Exporter *e = ctx;
+    Output *out = e->out;
+
+    if (e->format == EXPORT_CSV) {
+        out_csv_field(out, line->path);
+        out_write(out, ",", 1);
+        out_int(out, line->scene);
+        out_write(out, ",", 1);
+        out_int(out, line->dialog);
+        out_write(out, ",", 1);
+        out_int(out, line->line);
+        out_write(out, ",", 1);
+        out_csv_field(out, line->name);
+        out_write(out, ",", 1);
+        out_csv_field(out, line->text);
+        out_write(out, ",", 1);
+        out_csv_field(out, line->meta);
+        out_write(out, "\n", 1);
+    } else {
+        if (e->format == EXPORT_JSON) out_write(out, e->records ? ",\n" : "\n", e->records ? 2 : 1);
+        out_write(out, "{\"file\":", 8);
+        out_json_string(out, line->path);
+        json_int(out, ",\"scene\":", line->scene);
+        json_int(out, ",\"dialog\":", line->dialog);
+        json_int(out, ",\"line\":", line->line);
+        out_write(out, ",\"speaker\":", 11);
+        out_json_string(out, line->name);
+        out_write(out, ",\"text\":", 8);
+        out_json_string(out, line->text);
+        out_write(out, ",\"meta\":", 8);
+        out_json_string(out, line->meta);
+        out_write(out, "}", 1);
+        if (e->format == EXPORT_NDJSON) out_write(out, "\n", 1);
+    }
+
+    e->records++;
+}
+
+void export_end(Exporter *e) {
+    if (e->format == EXPORT_JSON) out_write(e->out, e->records ? "\n]\n" : "]\n", e->records ? 3 : 2);
+    out_flush(e->out);
+}
+
+int export_files(const char *const *files, const int count, const ExportFormat format, const char *output,
+                 const char *cast, const int verbose) {
+    Symbols *units = malloc(sizeof(Symbols) * (size_t) count);
+    if (!units) {
+        fprintf(stderr, "\033[1;31mError:\033[0m out of memory\n");
+        return 1;
+    }
+
+    FILE *f = output ? fopen(output, "wb") : stdout;
+    if (!f) {
+        fprintf(stderr, "\033[1;31mError:\033[0m cannot write %s\n", output);
+        free(units);
+        return 1;
+    }
+
+    // Records stream through a fixed buffer; diagnostics stay off the record stream
+    Output records, report, diag;
+    out_init_file(&records, f);
+    out_init_file(&report, output ? stdout : stderr);
+    out_init_memory(&diag);
+
+    Exporter e;
+    export_begin(&e, &records, format);
+
+    ModuleCache *modules = module_cache_new();
+
+    Table names;
+    table_init(&names);
+    int error = cast && modules ? load_cast(cast, modules, &names, &report) : 0;
+
+    // One file at a time keeps memory flat and the output in input order; only symbols are kept
+    for (int i = 0; i < count; i++) {
+        diag.len = 0;
+        symbols_init(&units[i], files[i]);
+        const CompileOptions opt = {verbose, &diag, &units[i], modules, export_line, &e};
+        const int errors = compile_unit(files[i], &opt);
+
+        if (verbose || errors) {
+            if (!verbose) verbose_header(&report, files[i]);
+            out_write(&report, diag.data, diag.len);
+        }
+        error += errors;
+    }
+
+    export_end(&e);
+
+    // A short write anywhere (including the buffer bypass) leaves the stream's error flag set
+    int failed = !out_flush(&records);
+    out_free(&records);
+    if (output && fclose(f) != 0) failed = 1;
+    if (failed) out_printf(&report, "\033[1;31mError:\033[0m cannot write %s\n", output ? output : "stdout");
+
+    // Link once every record is out
+    error += link_units(units, count, cast ? &names : NULL, error, 1, &report);
+    error += failed;
+    export_result(&report, count, e.records, error);
+
+    for (int i = 0; i < count; i++) symbols_free(&units[i]);
+    free(units);
+    table_free(&names);
+    module_cache_free(modules);
+    out_free(&diag);
+    out_free(&report);
+    return error;
+}
@@ -0,0 +1,37 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "compiler.h"
+#include "output.h"
+
+// Export formats
+typedef enum {
+    EXPORT_JSON,        // One array of records
+    EXPORT_NDJSON,      // One record per line
+    EXPORT_CSV          // Header row, then one row per record
+} ExportFormat;
+
+// Streaming record writer, records go straight to out
+typedef struct {
+    Output *out;
+    ExportFormat format;
+    long records;
+} Exporter;
+
+// Parse a format name (json, ndjson, csv), return 0 if unknown
+int export_format(const char *name, ExportFormat *format);
+
+void export_begin(Exporter *e, Output *out, ExportFormat format);
+
+// DialogHook: write one record (ctx is the Exporter)
+void export_line(const DialogLine *line, void *ctx);
+
+void export_end(Exporter *e);
+
+// Compile files one after another, exporting their dialog lines to output (NULL for stdout),
+// then link them like a project (checked against cast unless NULL). Returns the error count
+int export_files(const char *const *files, int count, ExportFormat format, const char *output, const char *cast,
+                 int verbose);
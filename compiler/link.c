@@ -0,0 +1,186 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "link.h"
+#include "array.h"
+#include "pool.h"
+#include "verbose.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void symbols_init(Symbols *s, const char *path) {
+    memset(s, 0, sizeof(*s));
+    s->path = path;
+}
+
+void symbols_free(Symbols *s) {
+    for (int i = 0; i < s->name_count; i++) free(s->names[i].name);
+    free(s->dialogs);
+    free(s->names);
+    free(s->refs);
+    memset(s, 0, sizeof(*s));
+}
+
+void symbols_add_dialog(Symbols *s, const int number, const int line) {
+    if (!array_grow((void **) &s->dialogs, &s->dialog_cap, s->dialog_count, sizeof(SymDialog))) return;
+    s->dialogs[s->dialog_count].number = number;
+    s->dialogs[s->dialog_count].line = line;
+    s->dialog_count++;
+}
+
+void symbols_add_name(Symbols *s, const char *name, const size_t len, const int line) {
+    if (!array_grow((void **) &s->names, &s->name_cap, s->name_count, sizeof(SymName))) return;
+    char *copy = malloc(len + 1);
+    if (!copy) return;
+    memcpy(copy, name, len);
+    copy[len] = '\0';
+    s->names[s->name_count].name = copy;
+    s->names[s->name_count].line = line;
+    s->name_count++;
+}
+
+void symbols_add_ref(Symbols *s, const int scene, const int dialog, const int line) {
+    if (!array_grow((void **) &s->refs, &s->ref_cap, s->ref_count, sizeof(SymRef))) return;
+    s->refs[s->ref_count].scene = scene;
+    s->refs[s->ref_count].dialog = dialog;
+    s->refs[s->ref_count].line = line;
+    s->ref_count++;
+}
+
+// Where an id is declared
+typedef struct {
+    int owner;      // Declaring unit
+    int line;
+} RegEntry;
+
+// Project registry: scene and dialog ids mapped to the unit declaring them
+typedef struct {
+    Table ids;      // "Scene.N" and "Scene.N/Dialog.M"
+    RegEntry *entries;  // By id
+    int cap;
+    int scenes;
+    int dialogs;
+} Registry;
+
+static int id_key(char *buf, const size_t size, const int scene, const int dialog) {
+    if (dialog) return snprintf(buf, size, "Scene.%d/Dialog.%d", scene, dialog);
+    return snprintf(buf, size, "Scene.%d", scene);
+}
+
+// Register an id, return the id index it collides with (or -1 when new)
+static int registry_add(Registry *r, const int scene, const int dialog, const int unit, const int line) {
+    char key[64];
+    const int len = id_key(key, sizeof(key), scene, dialog);
+
+    int added;
+    const int id = table_intern(&r->ids, key, (size_t) len, &added);
+    if (id < 0) return -1;
+    if (!added) return id;
+
+    // Ids are dense, so a new id is always the next entry
+    if (!array_grow((void **) &r->entries, &r->cap, id, sizeof(RegEntry))) return -1;
+    r->entries[id].owner = unit;
+    r->entries[id].line = line;
+    if (dialog) r->dialogs++;
+    else r->scenes++;
+    return -1;
+}
+
+// Per-unit resolution state (runs in parallel, registry is read-only)
+typedef struct {
+    const Symbols *units;
+    const Registry *reg;
+    const Table *cast;
+    Output *outs;
+    int *errors;
+} Resolve;
+
+static void resolve_unit(const int index, void *ctx) {
+    const Resolve *r = ctx;
+    const Symbols *u = &r->units[index];
+    Output *out = &r->outs[index];
+    char hint[256];
+
+    // Declared names must be in the cast
+    if (r->cast) {
+        for (int i = 0; i < u->name_count; i++) {
+            const SymName *n = &u->names[i];
+            if (table_find(r->cast, n->name, strlen(n->name)) >= 0) continue;
+            snprintf(hint, sizeof(hint), "add '%s' to the cast file", n->name);
+            link_error(out, u->path, n->line, "Character missing from cast", hint);
+            r->errors[index]++;
+        }
+    }
+
+    // Every Goto into another scene must land on a declared scene or dialog
+    for (int i = 0; i < u->ref_count; i++) {
+        const SymRef *ref = &u->refs[i];
+        const int scene = ref->scene;
+
+        char key[64];
+        const int len = id_key(key, sizeof(key), scene, ref->dialog);
+        if (table_find(&r->reg->ids, key, (size_t) len) >= 0) continue;
+
+        if (ref->dialog && table_find(&r->reg->ids, key, strcspn(key, "/")) >= 0)
+            snprintf(hint, sizeof(hint), "[Scene.%d] has no [Dialog.%d]", scene, ref->dialog);
+        else
+            snprintf(hint, sizeof(hint), "no file declares [Scene.%d]", scene);
+        link_error(out, u->path, ref->line, "Unresolved Goto target", hint);
+        r->errors[index]++;
+    }
+}
+
+int link_units(const Symbols *units, const int count, const Table *cast, const int compile_errors, const int threads,
+               Output *out) {
+    Registry reg;
+    memset(&reg, 0, sizeof(reg));
+    table_init(&reg.ids);
+
+    int error = 0;
+    char hint[256];
+
+    // Merge ids in input order, so the first declaration wins
+    for (int u = 0; u < count; u++) {
+        const Symbols *s = &units[u];
+        if (!s->scene) continue;
+
+        int other = registry_add(&reg, s->scene, 0, u, s->scene_line);
+        if (other >= 0) {
+            snprintf(hint, sizeof(hint), "already declared in %s:%d", units[reg.entries[other].owner].path, reg.entries[other].line);
+            link_error(out, s->path, s->scene_line, "Duplicate [Scene.N] in project", hint);
+            error++;
+            continue;
+        }
+
+        // Dialog numbers are already unique: compile_source() reports duplicates
+        for (int d = 0; d < s->dialog_count; d++)
+            registry_add(&reg, s->scene, s->dialogs[d].number, u, s->dialogs[d].line);
+    }
+
+    // Resolve references per unit
+    Output *outs = count > 0 ? malloc(sizeof(Output) * (size_t) count) : NULL;
+    int *errors = count > 0 ? calloc((size_t) count, sizeof(int)) : NULL;
+    if (outs && errors) {
+        for (int u = 0; u < count; u++) out_init_memory(&outs[u]);
+
+        Resolve r = {units, &reg, cast, outs, errors};
+        pool_run(count, threads, resolve_unit, &r);
+
+        for (int u = 0; u < count; u++) {
+            out_write(out, outs[u].data, outs[u].len);
+            out_free(&outs[u]);
+            error += errors[u];
+        }
+    }
+    free(outs);
+    free(errors);
+
+    link_result(out, count, reg.scenes, reg.dialogs, compile_errors + error);
+
+    free(reg.entries);
+    table_free(&reg.ids);
+    return error;
+}
@@ -0,0 +1,58 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "output.h"
+#include "table.h"
+
+// Name declared in Characters (or spoken when nothing is declared)
+typedef struct {
+    char *name;
+    int line;
+} SymName;
+
+// Dialog block header
+typedef struct {
+    int number;
+    int line;
+} SymDialog;
+
+// {Goto: ...} into another scene (compile_source() resolves the unit's own scene)
+typedef struct {
+    int scene;
+    int dialog;     // 0 when the whole scene is referenced
+    int line;
+} SymRef;
+
+// Symbols of one compiled file
+typedef struct Symbols {
+    const char *path;
+    int scene;          // 0 if the file has no valid [Scene.N]
+    int scene_line;
+
+    SymDialog *dialogs;
+    int dialog_count, dialog_cap;
+
+    SymName *names;
+    int name_count, name_cap;
+
+    SymRef *refs;
+    int ref_count, ref_cap;
+} Symbols;
+
+void symbols_init(Symbols *s, const char *path);
+
+void symbols_free(Symbols *s);
+
+void symbols_add_dialog(Symbols *s, int number, int line);
+
+void symbols_add_name(Symbols *s, const char *name, size_t len, int line);
+
+void symbols_add_ref(Symbols *s, int scene, int dialog, int line);
+
+// Merge units into a project registry and resolve cross-file references.
+// With a cast, every declared name must be in it. compile_errors (found before linking)
+// count towards the summary. Returns the link error count
+int link_units(const Symbols *units, int count, const Table *cast, int compile_errors, int threads, Output *out);
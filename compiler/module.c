@@ -0,0 +1,397 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "module.h"
+#include "array.h"
+#include "compiler.h"
+#include "parser.h"
+#include "pool.h"
+#include "table.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// File version a module was parsed from
+typedef struct {
+    long long mtime;    // -1 if the file could not be read
+    long long size;
+} Stamp;
+
+// Cache slot: reserved under the lock, filled once its parse finishes
+typedef struct {
+    Module *module;     // NULL while parsing (or if parsing failed)
+    int ready;
+    Stamp stamp;
+} CacheEntry;
+
+struct ModuleCache {
+    PoolMutex *lock;
+    PoolCond *ready;    // Broadcast whenever an entry becomes ready
+    Table paths;        // Normalized path -> entry index
+    CacheEntry *entries;
+    int cap;
+    int refs;           // Owners, see module_cache_retain()
+};
+
+static char *dup_range(const char *s, const size_t len) {
+    char *copy = malloc(len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+// Normalize separators, "." and ".." segments
+static void normalize(char *buf, const size_t size, const char *path) {
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s", path);
+    for (char *c = tmp; *c; ++c)
+        if (*c == '\\') *c = '/';
+
+    size_t len = 0;
+    size_t root = 0;
+    buf[0] = '\0';
+
+    // Keep the absolute prefix ("/" or "C:/")
+    const char *s = tmp;
+    if (s[0] && s[1] == ':') {
+        len = root = (size_t) snprintf(buf, size, "%c:", s[0]);
+        s += 2;
+    }
+    if (*s == '/') {
+        len = root = (size_t) snprintf(buf + len, size - len, "/") + len;
+        s++;
+    }
+
+    while (*s) {
+        const size_t seg = strcspn(s, "/");
+        if (seg == 1 && s[0] == '.') {
+            // Same directory
+        } else if (seg == 2 && s[0] == '.' && s[1] == '.') {
+            // Parent: drop the last segment unless there is none to drop
+            char *last = strrchr(buf + root, '/');
+            const char *name = last ? last + 1 : buf + root;
+            if (len > root && strcmp(name, "..") != 0) {
+                len = last ? (size_t) (last - buf) : root;
+                buf[len] = '\0';
+            } else if (!root) {
+                len += (size_t) snprintf(buf + len, size - len, "%s..", len > root ? "/" : "");
+            }
+        } else if (seg) {
+            len += (size_t) snprintf(buf + len, size - len, "%s%.*s", len > root ? "/" : "", (int) seg, s);
+        }
+        if (len >= size) {
+            buf[size - 1] = '\0';
+            return;
+        }
+        s += seg;
+        if (*s == '/') s++;
+    }
+}
+
+void module_resolve_path(char *buf, const size_t size, const char *from, const char *path) {
+    const int absolute = path[0] == '/' || path[0] == '\\' || (path[0] && path[1] == ':');
+    const char *slash = strrchr(from, '/');
+    const char *backslash = strrchr(from, '\\');
+    if (backslash > slash) slash = backslash;
+
+    char joined[1024];
+    if (absolute || !slash) snprintf(joined, sizeof(joined), "%s", path);
+    else snprintf(joined, sizeof(joined), "%.*s/%s", (int) (slash - from), from, path);
+    normalize(buf, size, joined);
+}
+
+static void add_error(Module *m, int *cap, const int line, const char *message, const char *hint,
+                      const char *content) {
+    if (!array_grow((void **) &m->errors, cap, m->error_count, sizeof(ModuleError))) return;
+    ModuleError *e = &m->errors[m->error_count++];
+    e->line = line;
+    e->message = message;
+    e->hint = hint;
+    e->content = content ? dup_range(content, strlen(content)) : NULL;
+}
+
+// Parse a module file
+static Module *module_parse(const char *path) {
+    Module *m = calloc(1, sizeof(Module));
+    if (!m) return NULL;
+    m->path = dup_range(path, strlen(path));
+
+    int names_cap = 0, imports_cap = 0, import_lines_cap = 0, errors_cap = 0;
+    size_t len = 0;
+    char *src = read_source(path, &len);
+    if (!src) {
+        add_error(m, &errors_cap, 0, "Cannot open imported file", "check the Import path", NULL);
+        return m;
+    }
+
+    int line_num = 0;
+    char *line = src;
+    while (line < src + len) {
+        char *nl = memchr(line, '\n', (size_t) (src + len - line));
+        if (nl) *nl = '\0';
+        line_num++;
+
+        char *original = dup_range(line, strlen(line));
+        ParsedLine p = parse_line(line);
+
+        switch (p.type) {
+            case LINE_EMPTY:
+            case LINE_COMMENT:
+                break;
+
+            case LINE_LEVEL:
+                if (m->level) add_error(m, &errors_cap, line_num, "Duplicate Level", "remove extra Level definition",
+                                        original);
+                else m->level = dup_range(p.value, strlen(p.value));
+                break;
+
+            case LINE_LOCATION:
+                if (m->location) add_error(m, &errors_cap, line_num, "Duplicate Location",
+                                           "remove extra Location definition", original);
+                else m->location = dup_range(p.value, strlen(p.value));
+                break;
+
+            case LINE_CHARACTERS: {
+                const char *name;
+                size_t name_len;
+                for (const char *s = p.value; (s = next_name(s, &name, &name_len));) {
+                    if (!array_grow((void **) &m->names, &names_cap, m->name_count, sizeof(char *))) break;
+                    m->names[m->name_count++] = dup_range(name, name_len);
+                }
+                break;
+            }
+
+            case LINE_IMPORT: {
+                if (!p.value[0]) {
+                    add_error(m, &errors_cap, line_num, "Empty Import path", "use 'Import: file.ds'", original);
+                    break;
+                }
+                char resolved[1024];
+                module_resolve_path(resolved, sizeof(resolved), path, p.value);
+                if (!array_grow((void **) &m->imports, &imports_cap, m->import_count, sizeof(char *))) break;
+                if (!array_grow((void **) &m->import_lines, &import_lines_cap, m->import_count, sizeof(int))) break;
+                m->imports[m->import_count] = dup_range(resolved, strlen(resolved));
+                m->import_lines[m->import_count] = line_num;
+                m->import_count++;
+                break;
+            }
+
+            default:
+                add_error(m, &errors_cap, line_num, "Only metadata allowed in imported file",
+                          "use Level, Location, Characters or Import", original);
+                break;
+        }
+
+        free_parsed_line(&p);
+        free(original);
+        line = nl ? nl + 1 : src + len;
+    }
+
+    free(src);
+    return m;
+}
+
+static void module_free(Module *m) {
+    if (!m) return;
+    for (int i = 0; i < m->name_count; i++) free(m->names[i]);
+    for (int i = 0; i < m->import_count; i++) free(m->imports[i]);
+    for (int i = 0; i < m->error_count; i++) free(m->errors[i].content);
+    free(m->names);
+    free(m->imports);
+    free(m->import_lines);
+    free(m->errors);
+    free(m->level);
+    free(m->location);
+    free(m->path);
+    free(m);
+}
+
+ModuleCache *module_cache_new(void) {
+    ModuleCache *c = calloc(1, sizeof(ModuleCache));
+    if (!c) return NULL;
+    c->lock = pool_mutex_new();
+    c->ready = pool_cond_new();
+    if (!c->lock || !c->ready) {
+        pool_mutex_free(c->lock);
+        pool_cond_free(c->ready);
+        free(c);
+        return NULL;
+    }
+    table_init(&c->paths);
+    c->refs = 1;
+    return c;
+}
+
+ModuleCache *module_cache_retain(ModuleCache *c) {
+    if (!c) return NULL;
+    pool_lock(c->lock);
+    c->refs++;
+    pool_unlock(c->lock);
+    return c;
+}
+
+void module_cache_release(ModuleCache *c) {
+    if (!c) return;
+    pool_lock(c->lock);
+    const int refs = --c->refs;
+    pool_unlock(c->lock);
+    if (!refs) module_cache_free(c);
+}
+
+static Stamp file_stamp(const char *path) {
+    struct stat st;
+    Stamp s = {-1, -1};
+    if (stat(path, &st) == 0) {
+        s.mtime = (long long) st.st_mtime;
+        s.size = (long long) st.st_size;
+    }
+    return s;
+}
+
+void module_release(ModuleCache *c, const Module *m) {
+    if (!m) return;
+    Module *owned = (Module *) m;
+    pool_lock(c->lock);
+    const int refs = --owned->refs;
+    pool_unlock(c->lock);
+    if (!refs) module_free(owned);
+}
+
+void module_cache_free(ModuleCache *c) {
+    if (!c) return;
+    for (int i = 0; i < c->paths.count; i++) module_free(c->entries[i].module);
+    table_free(&c->paths);
+    free(c->entries);
+    pool_cond_free(c->ready);
+    pool_mutex_free(c->lock);
+    free(c);
+}
+
+const Module *module_get(ModuleCache *c, const char *path) {
+    // The file version is taken before parsing, so an edit made during the parse is seen next time
+    const Stamp stamp = file_stamp(path);
+
+    pool_lock(c->lock);
+
+    // Room for one more entry before the path gets an index
+    if (!array_grow((void **) &c->entries, &c->cap, c->paths.count, sizeof(CacheEntry))) {
+        pool_unlock(c->lock);
+        return NULL;
+    }
+
+    int added;
+    const int index = table_intern(&c->paths, path, strlen(path), &added);
+    if (index < 0) {
+        pool_unlock(c->lock);
+        return NULL;
+    }
+
+    CacheEntry *entry = NULL;
+    Module *stale = NULL;
+    if (!added) {
+        // Another thread is parsing this path: wait for it (parsing never waits, so this cannot deadlock)
+        while (!c->entries[index].ready) pool_wait(c->ready, c->lock);
+        entry = &c->entries[index];
+
+        if (entry->stamp.mtime == stamp.mtime && entry->stamp.size == stamp.size) {
+            Module *m = entry->module;
+            if (m) m->refs++;
+            pool_unlock(c->lock);
+            return m;
+        }
+
+        // The file changed: parse it again, running walks keep the old module until they release it
+        stale = entry->module;
+    }
+
+    // Reserve the entry and parse without holding the lock
+    entry = &c->entries[index];
+    entry->module = NULL;
+    entry->ready = 0;
+    pool_unlock(c->lock);
+
+    module_release(c, stale);
+    Module *m = module_parse(path);
+    if (m) m->refs = 2;     // The cache entry and the caller
+
+    // entries may have moved while unlocked
+    pool_lock(c->lock);
+    entry = &c->entries[index];
+    entry->module = m;
+    entry->stamp = stamp;
+    entry->ready = 1;
+    pool_broadcast(c->ready);
+    pool_unlock(c->lock);
+    return m;
+}
+
+// Depth-first walk state
+typedef struct {
+    ModuleCache *cache;
+    ModuleVisit fn;
+    void *ctx;
+    Table visited;
+    const char **stack;     // Current import chain
+    int depth;
+    int stack_cap;
+    char *cycle;
+    size_t cycle_size;
+} Walk;
+
+static int walk(Walk *w, const char *path) {
+    // Already on the chain: import cycle
+    for (int i = 0; i < w->depth; i++) {
+        if (strcmp(w->stack[i], path) != 0) continue;
+        if (w->cycle_size && !w->cycle[0]) {
+            size_t len = 0;
+            for (int j = i; j < w->depth && len < w->cycle_size; j++)
+                len += (size_t) snprintf(w->cycle + len, w->cycle_size - len, "%s -> ", w->stack[j]);
+            if (len < w->cycle_size) snprintf(w->cycle + len, w->cycle_size - len, "%s", path);
+        }
+        return -1;
+    }
+
+    int added;
+    table_intern(&w->visited, path, strlen(path), &added);
+    if (!added) return 0;
+
+    const Module *m = module_get(w->cache, path);
+    if (!m) return 0;
+    w->fn(m, w->ctx);
+
+    // The module stays retained while its path is on the chain
+    int result = 0;
+    if (array_grow((void **) &w->stack, &w->stack_cap, w->depth, sizeof(char *))) {
+        w->stack[w->depth++] = m->path;
+        for (int i = 0; i < m->import_count; i++)
+            if (walk(w, m->imports[i]) < 0) result = -1;
+        w->depth--;
+    }
+
+    module_release(w->cache, m);
+    return result;
+}
+
+int module_walk(ModuleCache *c, const char *root, const char *path, const ModuleVisit fn, void *ctx,
+                char *cycle, const size_t cycle_size) {
+    char normalized_root[1024];
+    module_resolve_path(normalized_root, sizeof(normalized_root), "", root);
+    if (cycle_size) cycle[0] = '\0';
+
+    Walk w = {c, fn, ctx, {0}, NULL, 0, 0, cycle, cycle_size};
+    table_init(&w.visited);
+
+    int result = 0;
+    if (array_grow((void **) &w.stack, &w.stack_cap, 0, sizeof(char *))) {
+        w.stack[w.depth++] = normalized_root;
+        result = walk(&w, path);
+    }
+
+    free(w.stack);
+    table_free(&w.visited);
+    return result;
+}
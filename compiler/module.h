@@ -0,0 +1,65 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+// Problem found while parsing a module
+typedef struct {
+    int line;               // 0 if the file could not be read
+    const char *message;
+    const char *hint;
+    char *content;          // Offending line, may be NULL
+} ModuleError;
+
+// Imported file: shared metadata only (Level, Location, Characters, Import).
+// Parsed once per cache and never modified afterwards
+typedef struct {
+    char *path;             // Normalized path
+    char *level;            // NULL if not set
+    char *location;         // NULL if not set
+
+    char **names;           // Characters
+    int name_count;
+
+    char **imports;         // Normalized paths of nested imports
+    int *import_lines;
+    int import_count;
+
+    ModuleError *errors;
+    int error_count;
+
+    int refs;               // Cache entry and callers of module_get(), guarded by the cache
+} Module;
+
+typedef struct ModuleCache ModuleCache;
+
+ModuleCache *module_cache_new(void);
+
+void module_cache_free(ModuleCache *c);
+
+// A new cache has one owner. Retain adds one (returns c), release drops one
+// and frees the cache with the last owner. Both are thread-safe
+ModuleCache *module_cache_retain(ModuleCache *c);
+
+void module_cache_release(ModuleCache *c);
+
+// Parsed module for a normalized path (thread-safe), release it with module_release().
+// Parsed on first use and again whenever the file's mtime or size changes. Parsing runs
+// outside the cache lock; threads asking for the same path wait for it
+const Module *module_get(ModuleCache *c, const char *path);
+
+void module_release(ModuleCache *c, const Module *m);
+
+// Resolve path relative to the directory of from, normalized
+void module_resolve_path(char *buf, size_t size, const char *from, const char *path);
+
+// Called once per module reached by module_walk()
+typedef void (*ModuleVisit)(const Module *m, void *ctx);
+
+// Visit the module at path and everything it imports (depth-first, each module once).
+// root is the importing file. Returns 0, or -1 on an import cycle (described in cycle)
+int module_walk(ModuleCache *c, const char *root, const char *path, ModuleVisit fn, void *ctx,
+                char *cycle, size_t cycle_size);
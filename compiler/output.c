@@ -0,0 +1,172 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "output.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OUT_FILE_BUFFER (64 * 1024)    // Stream buffer size
+#define OUT_MEMORY_START 4096          // Initial memory buffer size
+
+void out_init_file(Output *out, FILE *file) {
+    out->file = file;
+    out->len = 0;
+    out->data = malloc(OUT_FILE_BUFFER);
+    out->cap = out->data ? OUT_FILE_BUFFER : 0;
+}
+
+void out_init_memory(Output *out) {
+    out->file = NULL;
+    out->data = NULL;
+    out->len = 0;
+    out->cap = 0;
+}
+
+// Make room for n more bytes, return 0 if not possible
+static int reserve(Output *out, const size_t n) {
+    if (out->len + n <= out->cap) return 1;
+
+    if (out->file) {
+        out_flush(out);
+        return n <= out->cap;
+    }
+
+    size_t cap = out->cap ? out->cap : OUT_MEMORY_START;
+    while (cap < out->len + n) cap *= 2;
+    char *data = realloc(out->data, cap);
+    if (!data) return 0;
+    out->data = data;
+    out->cap = cap;
+    return 1;
+}
+
+void out_write(Output *out, const char *data, const size_t len) {
+    if (!len) return;
+    if (reserve(out, len)) {
+        memcpy(out->data + out->len, data, len);
+        out->len += len;
+    } else if (out->file) {
+        // Larger than the whole buffer: bypass it
+        fwrite(data, 1, len, out->file);
+    }
+}
+
+void out_printf(Output *out, const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    const int n = vsnprintf(out->data ? out->data + out->len : NULL, out->cap - out->len, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+
+    // Fits in the current buffer
+    if ((size_t) n < out->cap - out->len) {
+        out->len += (size_t) n;
+        return;
+    }
+
+    // Retry with enough room (or a temporary buffer for huge stream writes)
+    if (reserve(out, (size_t) n + 1)) {
+        va_start(ap, fmt);
+        vsnprintf(out->data + out->len, out->cap - out->len, fmt, ap);
+        va_end(ap);
+        out->len += (size_t) n;
+    } else if (out->file) {
+        char *tmp = malloc((size_t) n + 1);
+        if (!tmp) return;
+        va_start(ap, fmt);
+        vsnprintf(tmp, (size_t) n + 1, fmt, ap);
+        va_end(ap);
+        fwrite(tmp, 1, (size_t) n, out->file);
+        free(tmp);
+    }
+}
+
+void out_int(Output *out, const long value) {
+    char buf[24];
+    char *p = buf + sizeof(buf);
+    unsigned long v = value < 0 ? 0UL - (unsigned long) value : (unsigned long) value;
+
+    do {
+        *--p = (char) ('0' + v % 10);
+        v /= 10;
+    } while (v);
+    if (value < 0) *--p = '-';
+    out_write(out, p, (size_t) (buf + sizeof(buf) - p));
+}
+
+// Escapes are written between runs of plain bytes, so nothing is copied twice
+void out_json_string(Output *out, const char *s) {
+    static const char hex[] = "0123456789abcdef";
+    if (!s) {
+        out_write(out, "null", 4);
+        return;
+    }
+
+    out_write(out, "\"", 1);
+    const char *run = s;
+    for (; *s; ++s) {
+        const unsigned char c = (unsigned char) *s;
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out_write(out, run, (size_t) (s - run));
+        run = s + 1;
+        switch (c) {
+            case '"': out_write(out, "\\\"", 2);
+                break;
+            case '\\': out_write(out, "\\\\", 2);
+                break;
+            case '\n': out_write(out, "\\n", 2);
+                break;
+            case '\r': out_write(out, "\\r", 2);
+                break;
+            case '\t': out_write(out, "\\t", 2);
+                break;
+            default: {
+                const char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 15]};
+                out_write(out, esc, 6);
+                break;
+            }
+        }
+    }
+    out_write(out, run, (size_t) (s - run));
+    out_write(out, "\"", 1);
+}
+
+void out_csv_field(Output *out, const char *s) {
+    if (!s) return;
+
+    const size_t len = strlen(s);
+    if (strcspn(s, ",\"\r\n") == len) {
+        out_write(out, s, len);
+        return;
+    }
+
+    // Quoted: double every quote
+    out_write(out, "\"", 1);
+    const char *run = s;
+    for (const char *q; (q = strchr(run, '"'));) {
+        out_write(out, run, (size_t) (q - run + 1));
+        out_write(out, "\"", 1);
+        run = q + 1;
+    }
+    out_write(out, run, strlen(run));
+    out_write(out, "\"", 1);
+}
+
+int out_flush(Output *out) {
+    if (!out->file) return 1;
+    const size_t written = out->len ? fwrite(out->data, 1, out->len, out->file) : 0;
+    const int ok = written == out->len;
+    out->len = 0;
+    return fflush(out->file) == 0 && ok && !ferror(out->file);
+}
+
+void out_free(Output *out) {
+    out_flush(out);
+    free(out->data);
+    out->data = NULL;
+    out->len = out->cap = 0;
+}
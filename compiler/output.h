@@ -0,0 +1,44 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Output sink: either a buffered stream or a growing memory buffer
+typedef struct {
+    FILE *file;     // Flush target, NULL to keep everything in memory
+    char *data;     // Buffered bytes
+    size_t len;     // Bytes in use
+    size_t cap;     // Buffer capacity
+} Output;
+
+// Init sink writing to a stream (buffered)
+void out_init_file(Output *out, FILE *file);
+
+// Init sink collecting into memory
+void out_init_memory(Output *out);
+
+// Append raw bytes
+void out_write(Output *out, const char *data, size_t len);
+
+// Append formatted text
+void out_printf(Output *out, const char *fmt, ...);
+
+// Append a decimal number
+void out_int(Output *out, long value);
+
+// Append a quoted JSON string (NULL writes null)
+void out_json_string(Output *out, const char *s);
+
+// Append a CSV field, quoted only when needed (NULL writes an empty field)
+void out_csv_field(Output *out, const char *s);
+
+// Write buffered bytes to the stream (no-op for memory sinks).
+// Returns 0 if the stream has had a write error
+int out_flush(Output *out);
+
+// Flush and release the buffer
+void out_free(Output *out);
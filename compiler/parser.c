@@ -5,6 +5,7 @@
 #include "parser.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdbool.h>
@@ -128,6 +129,11 @@ ParsedLine parse_line(const char *line) {
             pl.value = skip_ws(colon + 1);
             return pl;
         }
+        if (strneq_ci(s, "import", kw_len) && kw_len == 6) {
+            pl.type = LINE_IMPORT;
+            pl.value = rtrim(skip_ws(colon + 1));
+            return pl;
+        }
 
         // Typos in metadata keywords
         // TODO: improve typo detection
@@ -143,6 +149,10 @@ ParsedLine parse_line(const char *line) {
             pl.type = LINE_ERROR_TYPO_CHARACTERS;
             return pl;
         }
+        if (kw_len >= 5 && (strneq_ci(s, "impor", kw_len) || strneq_ci(s, "improt", kw_len))) {
+            pl.type = LINE_ERROR_TYPO_IMPORT;
+            return pl;
+        }
     }
 
     // Dialog line
@@ -222,6 +232,69 @@ ParsedLine parse_line(const char *line) {
     return pl;
 }
 
+const char *next_name(const char *list, const char **name, size_t *len) {
+    while (list && *list) {
+        const char *start = skip_ws(list);
+        const char *end = start + strcspn(start, ",");
+        const char *next = *end ? end + 1 : end;
+
+        // Trim and skip empty entries
+        while (end > start && isspace((unsigned char) end[-1])) end--;
+        if (end > start) {
+            *name = start;
+            *len = (size_t) (end - start);
+            return next;
+        }
+        list = next;
+    }
+    return NULL;
+}
+
+// Parse "Keyword.N" at s, return the position after it or NULL
+static const char *parse_ref_part(const char *s, const char *keyword, int *num) {
+    const size_t kw_len = strlen(keyword);
+    if (!strneq_ci(s, keyword, kw_len) || s[kw_len] != '.') return NULL;
+
+    s += kw_len + 1;
+    if (!isdigit((unsigned char) *s)) return NULL;
+    *num = atoi(s);
+    s += strspn(s, "0123456789");
+    return *num > 0 ? s : NULL;
+}
+
+int parse_goto(const char *meta, int *scene, int *dialog) {
+    *scene = *dialog = 0;
+
+    // Find the Goto key (at the start of a block or after a separator)
+    const char *key = NULL;
+    for (const char *c = meta; *c; ++c) {
+        if (strneq_ci(c, "goto", 4) && (c == meta || c[-1] == '{' || c[-1] == ',' || isspace((unsigned char) c[-1]))) {
+            const char *after = skip_ws(c + 4);
+            if (*after == ':') {
+                key = after + 1;
+                break;
+            }
+        }
+    }
+    if (!key) return 0;
+
+    const char *s = skip_ws(key);
+    const char *after = parse_ref_part(s, "scene", scene);
+    if (after) {
+        if (*after == '/') {
+            after = parse_ref_part(after + 1, "dialog", dialog);
+            if (!after) return -1;
+        }
+    } else {
+        after = parse_ref_part(s, "dialog", dialog);
+        if (!after) return -1;
+    }
+
+    // Only the closing brace or another key may follow
+    after = skip_ws(after);
+    return *after == '}' || *after == ',' || !*after ? 1 : -1;
+}
+
 void free_parsed_line(const ParsedLine *pl) {
     (void) pl;
 }
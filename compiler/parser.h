@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <stddef.h>
+
 // Line types
 typedef enum {
     LINE_EMPTY,
@@ -13,6 +15,7 @@ typedef enum {
     LINE_LEVEL,
     LINE_LOCATION,
     LINE_CHARACTERS,
+    LINE_IMPORT,
     LINE_DIALOG,
     LINE_UNKNOWN,
     LINE_ERROR_EMPTY_NAME,
@@ -28,6 +31,7 @@ typedef enum {
     LINE_ERROR_TYPO_LEVEL,
     LINE_ERROR_TYPO_LOCATION,
     LINE_ERROR_TYPO_CHARACTERS,
+    LINE_ERROR_TYPO_IMPORT,
     LINE_ERROR_EXTRA_SPACE_IN_HEADER,
     LINE_ERROR_EXTRA_SPACE_IN_METADATA,
     LINE_ERROR_LEADING_SPACE
@@ -37,7 +41,7 @@ typedef enum {
 typedef struct {
     LineType type;
     int number;     // Scene or dialog number
-    char *value;    // For metadata (Level, Location, Characters)
+    char *value;    // For metadata (Level, Location, Characters) and Import path
     char *name;     // Character name in dialog
     char *text;     // Dialog text
     char *meta;     // Metadata block {..}
@@ -46,5 +50,13 @@ typedef struct {
 // Parse a single line and return its type and data
 ParsedLine parse_line(const char *line);
 
+// Next name from a comma-separated list (e.g. Characters value).
+// Returns the position to continue from, or NULL when the list is over
+const char *next_name(const char *list, const char **name, size_t *len);
+
+// Find {Goto: Scene.N/Dialog.M} (or {Goto: Dialog.M}) in a metadata block.
+// Returns 1 if found (scene = 0 means current scene), 0 if absent, -1 if malformed
+int parse_goto(const char *meta, int *scene, int *dialog);
+
 // Free parsed line resources (if any allocated)
 void free_parsed_line(const ParsedLine *pl);
@@ -0,0 +1,189 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "pool.h"
+
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct PoolMutex {
+#ifdef _WIN32
+    CRITICAL_SECTION cs;
+#else
+    pthread_mutex_t mutex;
+#endif
+};
+
+PoolMutex *pool_mutex_new(void) {
+    PoolMutex *m = malloc(sizeof(*m));
+    if (!m) return NULL;
+#ifdef _WIN32
+    InitializeCriticalSection(&m->cs);
+#else
+    pthread_mutex_init(&m->mutex, NULL);
+#endif
+    return m;
+}
+
+void pool_mutex_free(PoolMutex *m) {
+    if (!m) return;
+#ifdef _WIN32
+    DeleteCriticalSection(&m->cs);
+#else
+    pthread_mutex_destroy(&m->mutex);
+#endif
+    free(m);
+}
+
+void pool_lock(PoolMutex *m) {
+#ifdef _WIN32
+    EnterCriticalSection(&m->cs);
+#else
+    pthread_mutex_lock(&m->mutex);
+#endif
+}
+
+void pool_unlock(PoolMutex *m) {
+#ifdef _WIN32
+    LeaveCriticalSection(&m->cs);
+#else
+    pthread_mutex_unlock(&m->mutex);
+#endif
+}
+
+struct PoolCond {
+#ifdef _WIN32
+    CONDITION_VARIABLE cv;
+#else
+    pthread_cond_t cond;
+#endif
+};
+
+PoolCond *pool_cond_new(void) {
+    PoolCond *c = malloc(sizeof(*c));
+    if (!c) return NULL;
+#ifdef _WIN32
+    InitializeConditionVariable(&c->cv);
+#else
+    pthread_cond_init(&c->cond, NULL);
+#endif
+    return c;
+}
+
+void pool_cond_free(PoolCond *c) {
+    if (!c) return;
+#ifndef _WIN32
+    pthread_cond_destroy(&c->cond);
+#endif
+    free(c);
+}
+
+void pool_wait(PoolCond *c, PoolMutex *m) {
+#ifdef _WIN32
+    SleepConditionVariableCS(&c->cv, &m->cs, INFINITE);
+#else
+    pthread_cond_wait(&c->cond, &m->mutex);
+#endif
+}
+
+void pool_broadcast(PoolCond *c) {
+#ifdef _WIN32
+    WakeAllConditionVariable(&c->cv);
+#else
+    pthread_cond_broadcast(&c->cond);
+#endif
+}
+
+int pool_cpu_count(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const int n = (int) info.dwNumberOfProcessors;
+#else
+    const int n = (int) sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+// Shared work state: workers grab the next index until none are left
+typedef struct {
+    PoolMutex *lock;
+    int next;
+    int jobs;
+    PoolJob fn;
+    void *ctx;
+} Work;
+
+static void work_loop(Work *w) {
+    for (;;) {
+        pool_lock(w->lock);
+        const int i = w->next < w->jobs ? w->next++ : -1;
+        pool_unlock(w->lock);
+        if (i < 0) return;
+        w->fn(i, w->ctx);
+    }
+}
+
+#ifdef _WIN32
+static DWORD WINAPI worker(LPVOID arg) {
+    work_loop(arg);
+    return 0;
+}
+#else
+static void *worker(void *arg) {
+    work_loop(arg);
+    return NULL;
+}
+#endif
+
+void pool_run(const int jobs, int threads, const PoolJob fn, void *ctx) {
+    if (jobs <= 0) return;
+    if (threads > jobs) threads = jobs;
+
+    Work w = {pool_mutex_new(), 0, jobs, fn, ctx};
+
+    // Single worker (or no mutex): just run inline
+    if (threads <= 1 || !w.lock) {
+        for (int i = 0; i < jobs; i++) fn(i, ctx);
+        pool_mutex_free(w.lock);
+        return;
+    }
+
+    // The calling thread is one of the workers
+#ifdef _WIN32
+    HANDLE *ids = malloc(sizeof(HANDLE) * (size_t) (threads - 1));
+#else
+    pthread_t *ids = malloc(sizeof(pthread_t) * (size_t) (threads - 1));
+#endif
+    int started = 0;
+    for (int t = 0; ids && t < threads - 1; t++) {
+#ifdef _WIN32
+        ids[t] = CreateThread(NULL, 0, worker, &w, 0, NULL);
+        if (!ids[t]) break;
+#else
+        if (pthread_create(&ids[t], NULL, worker, &w) != 0) break;
+#endif
+        started++;
+    }
+
+    work_loop(&w);
+
+    for (int t = 0; t < started; t++) {
+#ifdef _WIN32
+        WaitForSingleObject(ids[t], INFINITE);
+        CloseHandle(ids[t]);
+#else
+        pthread_join(ids[t], NULL);
+#endif
+    }
+
+    free(ids);
+    pool_mutex_free(w.lock);
+}
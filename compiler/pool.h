@@ -0,0 +1,38 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+// Job callback: index is in [0, jobs)
+typedef void (*PoolJob)(int index, void *ctx);
+
+// Opaque mutex
+typedef struct PoolMutex PoolMutex;
+
+// Opaque condition variable, used together with a PoolMutex
+typedef struct PoolCond PoolCond;
+
+// Number of online CPUs (at least 1)
+int pool_cpu_count(void);
+
+// Run fn for every index in [0, jobs) on up to threads workers, wait for all
+void pool_run(int jobs, int threads, PoolJob fn, void *ctx);
+
+PoolMutex *pool_mutex_new(void);
+
+void pool_mutex_free(PoolMutex *m);
+
+void pool_lock(PoolMutex *m);
+
+void pool_unlock(PoolMutex *m);
+
+PoolCond *pool_cond_new(void);
+
+void pool_cond_free(PoolCond *c);
+
+// Release m, sleep until woken, then take m again. Callers re-check their condition
+void pool_wait(PoolCond *c, PoolMutex *m);
+
+// Wake every thread waiting on c
+void pool_broadcast(PoolCond *c);
@@ -0,0 +1,138 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "project.h"
+#include "compiler.h"
+#include "link.h"
+#include "module.h"
+#include "pool.h"
+#include "table.h"
+#include "verbose.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cast loading state passed to add_cast()
+typedef struct {
+    Table *cast;
+    Output *out;
+    const char *path;
+    int error;
+} Cast;
+
+// Collect the names of one cast module (the cast file or anything it imports)
+static void add_cast(const Module *m, void *ctx) {
+    Cast *c = ctx;
+
+    for (int i = 0; i < m->error_count; i++) {
+        if (!c->error) verbose_header(c->out, c->path);
+        const ModuleError *e = &m->errors[i];
+        char msg[1280];
+        snprintf(msg, sizeof(msg), "%s (%s)", e->message, m->path);
+        brief_error(c->out, e->line, msg, e->hint, e->content, 0);
+        c->error++;
+    }
+
+    for (int i = 0; i < m->name_count; i++)
+        table_intern(c->cast, m->names[i], strlen(m->names[i]), NULL);
+}
+
+int load_cast(const char *path, ModuleCache *modules, Table *cast, Output *out) {
+    char target[1024], cycle[1024];
+    module_resolve_path(target, sizeof(target), "", path);
+
+    Cast c = {cast, out, path, 0};
+    if (module_walk(modules, "", target, add_cast, &c, cycle, sizeof(cycle)) < 0) {
+        if (!c.error) verbose_header(out, path);
+        brief_error(out, 0, "Import cycle", cycle, NULL, 0);
+        c.error++;
+    }
+    return c.error;
+}
+
+// Shared batch state, each worker only touches its own index
+typedef struct {
+    const char *const *files;
+    const BatchOptions *opt;
+    Output *outs;
+    int *errors;
+} Batch;
+
+static void batch_unit(const int index, void *ctx) {
+    const Batch *b = ctx;
+    const BatchOptions *o = b->opt;
+    void *hook_ctx = o->on_dialog ? (char *) o->hook_ctx + o->hook_ctx_size * (size_t) index : NULL;
+    const CompileOptions opt = {o->verbose, &b->outs[index], o->units ? &o->units[index] : NULL, o->modules,
+                                o->on_dialog, hook_ctx};
+    b->errors[index] = compile_unit(b->files[index], &opt);
+}
+
+int compile_batch(const char *const *files, const int count, const BatchOptions *opt, Output *out) {
+    Output *outs = malloc(sizeof(Output) * (size_t) count);
+    int *errors = calloc((size_t) count, sizeof(int));
+    if (!outs || !errors) {
+        fprintf(stderr, "\033[1;31mError:\033[0m out of memory\n");
+        free(outs);
+        free(errors);
+        return 1;
+    }
+
+    // Files are independent
+    for (int i = 0; i < count; i++) out_init_memory(&outs[i]);
+    Batch b = {files, opt, outs, errors};
+    pool_run(count, opt->threads, batch_unit, &b);
+
+    int error = 0;
+    for (int i = 0; i < count; i++) {
+        if (opt->verbose || errors[i]) {
+            if (!opt->verbose) verbose_header(out, files[i]);
+            out_write(out, outs[i].data, outs[i].len);
+        }
+        out_free(&outs[i]);
+        error += errors[i];
+    }
+
+    free(outs);
+    free(errors);
+    return error;
+}
+
+int build_project(const char *const *files, const int count, const ProjectOptions *opt) {
+    const int threads = opt->jobs > 0 ? opt->jobs : pool_cpu_count();
+
+    Output out;
+    out_init_file(&out, stdout);
+
+    // Imported modules are parsed once and shared by every worker
+    ModuleCache *modules = module_cache_new();
+
+    Table cast;
+    table_init(&cast);
+    int error = opt->cast && modules ? load_cast(opt->cast, modules, &cast, &out) : 0;
+
+    Symbols *units = malloc(sizeof(Symbols) * (size_t) count);
+    if (!units) {
+        fprintf(stderr, "\033[1;31mError:\033[0m out of memory\n");
+        table_free(&cast);
+        module_cache_free(modules);
+        out_free(&out);
+        return 1;
+    }
+    for (int i = 0; i < count; i++) symbols_init(&units[i], files[i]);
+
+    // Compile phase
+    const BatchOptions batch = {opt->verbose, threads, modules, units, NULL, NULL, 0};
+    error += compile_batch(files, count, &batch, &out);
+
+    // Link phase
+    error += link_units(units, count, opt->cast ? &cast : NULL, error, threads, &out);
+
+    for (int i = 0; i < count; i++) symbols_free(&units[i]);
+    free(units);
+    table_free(&cast);
+    module_cache_free(modules);
+    out_free(&out);
+    return error;
+}
@@ -0,0 +1,40 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include "compiler.h"
+#include "link.h"
+#include "module.h"
+#include "output.h"
+#include "table.h"
+
+// Project build settings
+typedef struct {
+    int verbose;            // MODE_QUIET or MODE_VERBOSE
+    int jobs;               // Worker threads, <= 0 for one per CPU
+    const char *cast;       // Project cast file, may be NULL
+} ProjectOptions;
+
+// Settings of compile_batch()
+typedef struct {
+    int verbose;            // MODE_QUIET or MODE_VERBOSE
+    int threads;            // Worker threads
+    ModuleCache *modules;   // Import cache shared by every file
+    Symbols *units;         // One per file for the link step, may be NULL
+    DialogHook on_dialog;   // May be NULL
+    void *hook_ctx;         // One hook context per file, hook_ctx_size bytes apart
+    size_t hook_ctx_size;
+} BatchOptions;
+
+// Compile files on the pool, then write their diagnostics to out in input order
+// (in quiet mode only files with errors, each under its header). Returns the error count
+int compile_batch(const char *const *files, int count, const BatchOptions *opt, Output *out);
+
+// Load the project cast: a module whose Characters (including imported ones) form the cast.
+// Problems are reported to out under a header for path. Returns the error count
+int load_cast(const char *path, ModuleCache *modules, Table *cast, Output *out);
+
+// Compile every file in parallel, then link them. Returns the error count
+int build_project(const char *const *files, int count, const ProjectOptions *opt);
@@ -0,0 +1,101 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "table.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+// FNV-1a
+static unsigned hash_key(const char *key, const size_t len) {
+    unsigned h = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= (unsigned char) key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void table_init(Table *t) {
+    memset(t, 0, sizeof(*t));
+}
+
+void table_free(Table *t) {
+    for (int i = 0; i < t->count; ++i) free(t->keys[i]);
+    free(t->keys);
+    free(t->slots);
+    free(t->hashes);
+    memset(t, 0, sizeof(*t));
+}
+
+// Find the slot holding key or the empty slot where it belongs
+static int probe(const Table *t, const char *key, const size_t len, const unsigned h) {
+    const int mask = t->slots_cap - 1;
+    int s = (int) (h & (unsigned) mask);
+    while (t->slots[s]) {
+        const int i = t->slots[s] - 1;
+        if (t->hashes[i] == h && strncmp(t->keys[i], key, len) == 0 && t->keys[i][len] == '\0') return s;
+        s = (s + 1) & mask;
+    }
+    return s;
+}
+
+// Double the slot array (load factor stays below 1/2)
+static int grow_slots(Table *t) {
+    const int cap = t->slots_cap ? t->slots_cap * 2 : 16;
+    int *slots = calloc((size_t) cap, sizeof(int));
+    if (!slots) return 0;
+
+    free(t->slots);
+    t->slots = slots;
+    t->slots_cap = cap;
+    for (int i = 0; i < t->count; ++i) {
+        int s = (int) (t->hashes[i] & (unsigned) (cap - 1));
+        while (t->slots[s]) s = (s + 1) & (cap - 1);
+        t->slots[s] = i + 1;
+    }
+    return 1;
+}
+
+int table_intern(Table *t, const char *key, const size_t len, int *added) {
+    if (added) *added = 0;
+    if ((t->count + 1) * 2 > t->slots_cap && !grow_slots(t)) return -1;
+
+    const unsigned h = hash_key(key, len);
+    const int s = probe(t, key, len, h);
+    if (t->slots[s]) return t->slots[s] - 1;
+
+    if (t->count == t->keys_cap) {
+        const int cap = t->keys_cap ? t->keys_cap * 2 : 8;
+        char **keys = realloc(t->keys, (size_t) cap * sizeof(char *));
+        if (!keys) return -1;
+        t->keys = keys;
+        unsigned *hashes = realloc(t->hashes, (size_t) cap * sizeof(unsigned));
+        if (!hashes) return -1;
+        t->hashes = hashes;
+        t->keys_cap = cap;
+    }
+
+    char *copy = malloc(len + 1);
+    if (!copy) return -1;
+    memcpy(copy, key, len);
+    copy[len] = '\0';
+
+    const int index = t->count++;
+    t->keys[index] = copy;
+    t->hashes[index] = h;
+    t->slots[s] = index + 1;
+    if (added) *added = 1;
+    return index;
+}
+
+int table_find(const Table *t, const char *key, const size_t len) {
+    if (!t->slots_cap) return -1;
+    const int s = probe(t, key, len, hash_key(key, len));
+    return t->slots[s] ? t->slots[s] - 1 : -1;
+}
+
+const char *table_key(const Table *t, const int index) {
+    return index >= 0 && index < t->count ? t->keys[index] : NULL;
+}
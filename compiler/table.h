@@ -0,0 +1,30 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+
+// String interning table: every distinct key gets a dense index (0, 1, 2...)
+typedef struct {
+    char **keys;        // Owned key copies, by index
+    int count;          // Number of keys
+    int keys_cap;       // Capacity of keys
+    int *slots;         // Open addressing slots (index + 1, 0 = empty)
+    unsigned *hashes;   // Hash of each key, by index
+    int slots_cap;      // Number of slots (power of two)
+} Table;
+
+void table_init(Table *t);
+
+void table_free(Table *t);
+
+// Return the index of key, adding it if missing (*added set to 1 when new)
+int table_intern(Table *t, const char *key, size_t len, int *added);
+
+// Return the index of key, or -1 if missing
+int table_find(const Table *t, const char *key, size_t len);
+
+// Key string by index
+const char *table_key(const Table *t, int index);
@@ -3,96 +3,122 @@
 // See: http://www.apache.org/licenses/LICENSE-2.0
 
 #include "verbose.h"
-#include <stdio.h>
 
-void verbose_header(const char *fullpath) {
-    printf("\033[1;36mCompiling:\033[0m %s\n", fullpath);
+void verbose_header(Output *out, const char *fullpath) {
+    out_printf(out, "\033[1;36mCompiling:\033[0m %s\n", fullpath);
 }
 
-void verbose_footer(const int line_num, const int error) {
+void verbose_footer(Output *out, const int line_num, const int error) {
     if (error == 0) {
-        printf("\033[1;32mParsing completed:\033[0m %d lines processed\n", line_num);
+        out_printf(out, "\033[1;32mParsing completed:\033[0m %d lines processed\n", line_num);
     } else {
-        printf("\033[1;31mParsing broken:\033[0m %d lines processed, %d error(s)\n", line_num, error);
+        out_printf(out, "\033[1;31mParsing broken:\033[0m %d lines processed, %d error(s)\n", line_num, error);
     }
 }
 
-void verbose_empty_line(const int line_num) {
-    printf("\033[90m%4d │ \033[0m\n", line_num);
+void verbose_empty_line(Output *out, const int line_num) {
+    out_printf(out, "\033[90m%4d │ \033[0m\n", line_num);
 }
 
-void verbose_comment(const int line_num, const char *text) {
-    printf("\033[90m%4d │\033[2m –%s\033[0m\n", line_num, text);
+void verbose_comment(Output *out, const int line_num, const char *text) {
+    out_printf(out, "\033[90m%4d │\033[2m –%s\033[0m\n", line_num, text);
 }
 
-void verbose_scene(const int line_num, const int scene_num) {
-    printf("\033[1;36m%4d │ ◉ Scene %d\033[0m\n", line_num, scene_num);
+void verbose_scene(Output *out, const int line_num, const int scene_num) {
+    out_printf(out, "\033[1;36m%4d │ ◉ Scene %d\033[0m\n", line_num, scene_num);
 }
 
-void verbose_dialog(const int line_num, const int dialog_num) {
-    printf("\033[1;35m%4d │ ◆ Dialog %d\033[0m\n", line_num, dialog_num);
+void verbose_dialog(Output *out, const int line_num, const int dialog_num) {
+    out_printf(out, "\033[1;35m%4d │ ◆ Dialog %d\033[0m\n", line_num, dialog_num);
 }
 
-void verbose_level(const int line_num, const char *val) {
-    printf("\033[90m%4d │   \033[36mLevel:\033[0m %s\n", line_num, val);
+void verbose_level(Output *out, const int line_num, const char *val) {
+    out_printf(out, "\033[90m%4d │   \033[36mLevel:\033[0m %s\n", line_num, val);
 }
 
-void verbose_location(const int line_num, const char *val) {
-    printf("\033[90m%4d │   \033[36mLocation:\033[0m %s\n", line_num, val);
+void verbose_location(Output *out, const int line_num, const char *val) {
+    out_printf(out, "\033[90m%4d │   \033[36mLocation:\033[0m %s\n", line_num, val);
 }
 
-void verbose_characters(const int line_num, const char *val) {
-    printf("\033[90m%4d │   \033[36mCharacters:\033[0m %s\n", line_num, val);
+void verbose_characters(Output *out, const int line_num, const char *val) {
+    out_printf(out, "\033[90m%4d │   \033[36mCharacters:\033[0m %s\n", line_num, val);
 }
 
-void verbose_dialog_line(const int line_num, const char *name, const char *text, const char *meta) {
+void verbose_import(Output *out, const int line_num, const char *path) {
+    out_printf(out, "\033[90m%4d │   \033[36mImport:\033[0m %s\n", line_num, path);
+}
+
+void verbose_dialog_line(Output *out, const int line_num, const char *name, const char *text, const char *meta) {
     if (meta) {
-        printf("\033[90m%4d │   \033[1;37m%s:\033[0m %s \033[33m%s\033[0m\n",
+        out_printf(out, "\033[90m%4d │   \033[1;37m%s:\033[0m %s \033[33m%s\033[0m\n",
                line_num, name, text, meta);
     } else {
-        printf("\033[90m%4d │   \033[1;37m%s:\033[0m %s\n", line_num, name, text);
+        out_printf(out, "\033[90m%4d │   \033[1;37m%s:\033[0m %s\n", line_num, name, text);
     }
 }
 
-void verbose_error(const int line_num, const char *message, const char *hint, const char *line_content, int error_pos) {
-    printf("\033[1;31m%4d │ ✗ \033[1;31m%s\033[0m\n", line_num, message);
+void verbose_error(Output *out, const int line_num, const char *message, const char *hint, const char *line_content, int error_pos) {
+    out_printf(out, "\033[1;31m%4d │ ✗ \033[1;31m%s\033[0m\n", line_num, message);
     if (line_content) {
-        printf("\033[90m     │   \033[31m%s\033[0m\n", line_content);
+        out_printf(out, "\033[90m     │   \033[31m%s\033[0m\n", line_content);
         if (error_pos >= 0) {
-            printf("\033[90m     │   ");
-            for (int i = 0; i < error_pos; i++) printf(" ");
-            printf("\033[1;31m^\033[0m\n");
+            out_printf(out, "\033[90m     │   ");
+            for (int i = 0; i < error_pos; i++) out_printf(out, " ");
+            out_printf(out, "\033[1;31m^\033[0m\n");
         }
     }
     if (hint) {
-        printf("\033[90m     │   \033[1;90mHint:\033[0m \033[90m%s\033[0m\n", hint);
+        out_printf(out, "\033[90m     │   \033[1;90mHint:\033[0m \033[90m%s\033[0m\n", hint);
     }
 }
 
-void verbose_error_line(const int line_num, const char *line_content) {
-    printf("\033[1;31m%4d │ ✗\033[0m \033[31m%s\033[0m\n", line_num, line_content);
+void verbose_error_line(Output *out, const int line_num, const char *line_content) {
+    out_printf(out, "\033[1;31m%4d │ ✗\033[0m \033[31m%s\033[0m\n", line_num, line_content);
 }
 
-void brief_error(const int line_num, const char *message, const char *hint, const char *line_content, int error_pos) {
-    printf("\033[1;31m%4d │ ✗ \033[1;31m%s\033[0m\n", line_num, message);
+void brief_error(Output *out, const int line_num, const char *message, const char *hint, const char *line_content, int error_pos) {
+    out_printf(out, "\033[1;31m%4d │ ✗ \033[1;31m%s\033[0m\n", line_num, message);
     if (line_content) {
-        printf("\033[90m     │   \033[31m%s\033[0m\n", line_content);
+        out_printf(out, "\033[90m     │   \033[31m%s\033[0m\n", line_content);
         if (error_pos >= 0) {
-            printf("\033[90m     │   ");
-            for (int i = 0; i < error_pos; i++) printf(" ");
-            printf("\033[1;31m^\033[0m\n");
+            out_printf(out, "\033[90m     │   ");
+            for (int i = 0; i < error_pos; i++) out_printf(out, " ");
+            out_printf(out, "\033[1;31m^\033[0m\n");
         }
     }
     if (hint) {
-        printf("\033[90m     │   \033[1;90mHint:\033[0m \033[90m%s\033[0m\n", hint);
+        out_printf(out, "\033[90m     │   \033[1;90mHint:\033[0m \033[90m%s\033[0m\n", hint);
     }
 }
 
-void brief_result(const int line_num, const int error) {
+void brief_result(Output *out, const int line_num, const int error) {
     if (error == 0) {
-        printf("\033[1;32mParsing completed:\033[0m %d lines processed\n", line_num);
+        out_printf(out, "\033[1;32mParsing completed:\033[0m %d lines processed\n", line_num);
     } else {
-        printf("\033[1;31mParsing broken:\033[0m %d lines processed, %d error(s)\n", line_num, error);
+        out_printf(out, "\033[1;31mParsing broken:\033[0m %d lines processed, %d error(s)\n", line_num, error);
     }
     // TODO: add suggestion to use -v for more details
 }
+
+void link_error(Output *out, const char *path, const int line_num, const char *message, const char *hint) {
+    out_printf(out, "\033[1;31m%s:%d │ ✗ \033[1;31m%s\033[0m\n", path, line_num, message);
+    if (hint) {
+        out_printf(out, "\033[90m     │   \033[1;90mHint:\033[0m \033[90m%s\033[0m\n", hint);
+    }
+}
+
+void link_result(Output *out, const int files, const int scenes, const int dialogs, const int error) {
+    if (error == 0) {
+        out_printf(out, "\033[1;32mLinking completed:\033[0m %d files, %d scenes, %d dialogs\n", files, scenes, dialogs);
+    } else {
+        out_printf(out, "\033[1;31mLinking broken:\033[0m %d files, %d error(s)\n", files, error);
+    }
+}
+
+void export_result(Output *out, const int files, const long records, const int error) {
+    if (error == 0) {
+        out_printf(out, "\033[1;32mExport completed:\033[0m %d files, %ld records\n", files, records);
+    } else {
+        out_printf(out, "\033[1;31mExport broken:\033[0m %d files, %ld records, %d error(s)\n", files, records, error);
+    }
+}
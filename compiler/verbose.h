@@ -4,30 +4,40 @@
 
 #pragma once
 
-void verbose_header(const char *fullpath);
+#include "output.h"
 
-void verbose_footer(int line_num, int error);
+void verbose_header(Output *out, const char *fullpath);
 
-void verbose_empty_line(int line_num);
+void verbose_footer(Output *out, int line_num, int error);
 
-void verbose_comment(int line_num, const char *text);
+void verbose_empty_line(Output *out, int line_num);
 
-void verbose_scene(int line_num, int scene_num);
+void verbose_comment(Output *out, int line_num, const char *text);
 
-void verbose_dialog(int line_num, int dialog_num);
+void verbose_scene(Output *out, int line_num, int scene_num);
 
-void verbose_level(int line_num, const char *val);
+void verbose_dialog(Output *out, int line_num, int dialog_num);
 
-void verbose_location(int line_num, const char *val);
+void verbose_level(Output *out, int line_num, const char *val);
 
-void verbose_characters(int line_num, const char *val);
+void verbose_location(Output *out, int line_num, const char *val);
 
-void verbose_dialog_line(int line_num, const char *name, const char *text, const char *meta);
+void verbose_characters(Output *out, int line_num, const char *val);
 
-void verbose_error(int line_num, const char *message, const char *hint, const char *line_content, int error_pos);
+void verbose_import(Output *out, int line_num, const char *path);
 
-void verbose_error_line(int line_num, const char *line_content);
+void verbose_dialog_line(Output *out, int line_num, const char *name, const char *text, const char *meta);
 
-void brief_error(int line_num, const char *message, const char *hint, const char *line_content, int error_pos);
+void verbose_error(Output *out, int line_num, const char *message, const char *hint, const char *line_content, int error_pos);
 
-void brief_result(int line_num, int error);
+void verbose_error_line(Output *out, int line_num, const char *line_content);
+
+void brief_error(Output *out, int line_num, const char *message, const char *hint, const char *line_content, int error_pos);
+
+void brief_result(Output *out, int line_num, int error);
+
+void link_error(Output *out, const char *path, int line_num, const char *message, const char *hint);
+
+void link_result(Output *out, int files, int scenes, int dialogs, int error);
+
+void export_result(Output *out, int files, long records, int error);
@@ -3,13 +3,25 @@
 // See: http://www.apache.org/licenses/LICENSE-2.0
 
 #include "main.h"
+#include "../compiler/analyze.h"
 #include "../compiler/compiler.h"
+#include "../compiler/export.h"
+#include "../compiler/project.h"
+#include "server.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #define VERSION "0.0.1"
 
+// Report an option the selected mode would ignore
+static int option_error(const char *option, const char *with) {
+    printf("\033[1;31mError:\033[0m %s can't be used with %s\n", option, with);
+    printf("Use 'dialscript --help' for usage information\n");
+    return 1;
+}
+
 int main(int const argc, char *argv[]) {
     if (argc < 2) {
         hello();
@@ -18,54 +30,150 @@ int main(int const argc, char *argv[]) {
 
     // Default settings
     int mode = MODE_QUIET;
-    const char *filename = NULL;
+    int jobs = 0;
+    int jobs_set = 0;
+    int server = 0;
+    int analyze = 0;
+    const char *export_name = NULL;
+    const char *output = NULL;
+    const char *cast = NULL;
+    const char **files = malloc(sizeof(char *) * (size_t) argc);
+    int file_count = 0;
+
+    if (!files) return 1;
 
     // Parse arguments
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "--verbose") == 0) {
             mode = MODE_VERBOSE;
+        } else if (strncmp(argv[i], "--cast=", 7) == 0) {
+            cast = argv[i] + 7;
+        } else if (strncmp(argv[i], "--jobs=", 7) == 0) {
+            jobs = atoi(argv[i] + 7);
+            jobs_set = 1;
+        } else if (strcmp(argv[i], "--server") == 0) {
+            server = 1;
+        } else if (strcmp(argv[i], "--analyze") == 0) {
+            analyze = 1;
+        } else if (strncmp(argv[i], "--export=", 9) == 0) {
+            export_name = argv[i] + 9;
+        } else if (strncmp(argv[i], "--output=", 9) == 0) {
+            output = argv[i] + 9;
         } else if (strcmp(argv[i], "--help") == 0) {
             hello();
+            free(files);
             return 0;
         } else if (strcmp(argv[i], "--version") == 0) {
             printf("\033[1;36mDialScript v%s\033[0m\n", VERSION);
+            free(files);
             return 0;
         } else if (strcmp(argv[i], "--example") == 0) {
             example();
+            free(files);
             return 0;
         } else if (argv[i][0] != '-') {
-            filename = argv[i];
+            files[file_count++] = argv[i];
         } else {
             printf("\033[1;31mError:\033[0m unknown option '%s'\n", argv[i]);
             printf("Use 'dialscript --help' for usage information\n");
+            free(files);
             return 1;
         }
     }
 
-    // Check filename
-    if (!filename) {
+    // Persistent compile server, requests come from stdin
+    if (server) {
+        int error;
+        if (analyze) error = option_error("--analyze", "--server");
+        else if (export_name) error = option_error("--export", "--server");
+        else if (output) error = option_error("--output", "--server");
+        else if (cast) error = option_error("--cast", "--server");
+        else if (mode == MODE_VERBOSE) error = option_error("--verbose", "--server (send 'Verbose: 1' per request)");
+        else if (file_count) error = option_error("input files", "--server (send them as requests)");
+        else error = run_server(jobs);
+        free(files);
+        return error;
+    }
+
+    // Check filenames
+    if (!file_count) {
         printf("\033[1;31mError:\033[0m no input file specified\n");
+        free(files);
         return 1;
     }
 
-    // Check if filename ends with .ds
-    const size_t len = strlen(filename);
-    if (len < 3 || strcmp(filename + len - 3, ".ds") != 0) {
-        printf("\033[1;31mError:\033[0m only .ds files are supported\n");
+    // Check if every filename ends with .ds
+    for (int i = 0; i < file_count; i++) {
+        const size_t len = strlen(files[i]);
+        if (len < 3 || strcmp(files[i] + len - 3, ".ds") != 0) {
+            printf("\033[1;31mError:\033[0m only .ds files are supported\n");
+            free(files);
+            return 1;
+        }
+    }
+
+    // Word and line counts instead of linking
+    if (analyze) {
+        int error;
+        if (export_name) error = option_error("--export", "--analyze");
+        else if (cast) error = option_error("--cast", "--analyze");
+        else if (output) error = option_error("--output", "--analyze");
+        else error = analyze_files(files, file_count, jobs, mode) ? 1 : 0;
+        free(files);
+        return error;
+    }
+
+    // Stream dialog lines as records instead of linking
+    if (export_name) {
+        ExportFormat format;
+        if (!export_format(export_name, &format)) {
+            printf("\033[1;31mError:\033[0m unknown export format '%s' (use json, csv or ndjson)\n", export_name);
+            free(files);
+            return 1;
+        }
+        if (jobs_set) {
+            free(files);
+            return option_error("--jobs", "--export (files are exported in order)");
+        }
+        const int errors = export_files(files, file_count, format, output, cast, mode);
+        free(files);
+        return errors ? 1 : 0;
+    }
+
+    // Only an export has anything to write to --output
+    if (output) {
+        printf("\033[1;31mError:\033[0m --output needs --export\n");
+        printf("Use 'dialscript --help' for usage information\n");
+        free(files);
         return 1;
     }
 
+    // Several files (or a project cast or thread count): compile and link as a project
+    if (file_count > 1 || cast || jobs_set) {
+        const ProjectOptions opt = {mode, jobs, cast};
+        const int errors = build_project(files, file_count, &opt);
+        free(files);
+        return errors ? 1 : 0;
+    }
+
     // Compile normally
-    const char result = compile(filename, mode);
+    const char result = compile(files[0], mode);
+    free(files);
     return result;
 }
 
 // Usage info
 void hello(void) {
     printf("\033[1;36mDialScript v%s\033[0m\n", VERSION);
-    printf("\033[1;37mUsage:\033[0m dialscript <filename.ds> [options]\n\n");
+    printf("\033[1;37mUsage:\033[0m dialscript <filename.ds>... [options]\n\n");
     printf("\033[1;37mOptions:\033[0m\n");
     printf("  \033[1;32m--verbose\033[0m    Enable verbose mode\n");
+    printf("  \033[1;32m--cast=FILE\033[0m  Check every scene against a project cast file\n");
+    printf("  \033[1;32m--jobs=N\033[0m     Compile project files on N threads (default: all CPUs)\n");
+    printf("  \033[1;32m--server\033[0m     Serve framed compile requests over stdin/stdout\n");
+    printf("  \033[1;32m--analyze\033[0m    Report line, word and character counts per speaker\n");
+    printf("  \033[1;32m--export=FMT\033[0m Export dialog lines as json, csv or ndjson\n");
+    printf("  \033[1;32m--output=FILE\033[0m Write the export to FILE instead of stdout\n");
     printf("  \033[1;32m--help\033[0m       Show this help message\n");
     printf("  \033[1;32m--version\033[0m    Show version number\n");
     printf("  \033[1;32m--example\033[0m    Show example .ds file\n");
@@ -86,4 +194,5 @@ void example(void) {
     printf("\033[1;37mBeth:\033[0m Sure! \033[33m{Choices: 1, 2}\033[0m\n");
     printf("\033[1;37mAlan:\033[0m Great, let's go! \033[33m{Choice: 1}\033[0m\n");
     printf("\033[1;37mAlan:\033[0m Maybe next time then. \033[33m{Choice: 2}\033[0m\n");
+    printf("\033[1;37mBeth:\033[0m Let's meet at the lake. \033[33m{Goto: Scene.2/Dialog.1}\033[0m\n");
 }
@@ -0,0 +1,260 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#include "server.h"
+#include "../compiler/compiler.h"
+#include "../compiler/export.h"
+#include "../compiler/module.h"
+#include "../compiler/pool.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+#define MAX_FRAME (256 * 1024 * 1024)    // Largest accepted request payload
+
+// State shared by all workers
+typedef struct {
+    PoolMutex *in_lock;         // Held while reading one request
+    PoolMutex *out_lock;        // Held while writing one response
+    PoolMutex *cache_lock;      // Guards modules
+    ModuleCache *modules;       // Warm import cache, shared by all requests
+    int done;                   // Input closed (or framing broken)
+} Server;
+
+// Parsed request headers
+typedef struct {
+    char id[128];
+    char path[1024];
+    char name[1024];
+    int verbose;
+    int color;
+    int reload;
+    int export;             // Export the dialog lines as the artifact, -1 for an unknown format
+    ExportFormat format;
+    char format_name[64];
+    const char *body;
+    size_t body_len;
+} Request;
+
+// Read one frame into buf. Returns 1 on success, 0 at end of input, -1 if malformed
+static int read_frame(char **buf, size_t *cap, size_t *len) {
+    size_t n = 0;
+    int c, digits = 0;
+
+    while ((c = getchar()) != EOF && c != '\n') {
+        if (c == '\r') continue;
+        if (c < '0' || c > '9' || n > MAX_FRAME) return -1;
+        n = n * 10 + (size_t) (c - '0');
+        digits++;
+    }
+    if (!digits) return c == EOF ? 0 : -1;
+    if (n > MAX_FRAME) return -1;
+
+    if (n + 1 > *cap) {
+        char *grown = realloc(*buf, n + 1);
+        if (!grown) return -1;
+        *buf = grown;
+        *cap = n + 1;
+    }
+    if (fread(*buf, 1, n, stdin) != n) return -1;
+    (*buf)[n] = '\0';
+    *len = n;
+    return 1;
+}
+
+// Split payload into headers and body
+static void parse_request(char *payload, const size_t len, Request *req) {
+    memset(req, 0, sizeof(*req));
+    snprintf(req->name, sizeof(req->name), "<inline>");
+
+    char *s = payload;
+    char *end = payload + len;
+    while (s < end) {
+        char *nl = memchr(s, '\n', (size_t) (end - s));
+        char *line_end = nl ? nl : end;
+        if (line_end > s && line_end[-1] == '\r') line_end--;
+        *line_end = '\0';
+
+        char *next = nl ? nl + 1 : end;
+        if (!*s) {
+            s = next;
+            break;
+        }
+
+        char *colon = strchr(s, ':');
+        if (colon) {
+            *colon = '\0';
+            const char *value = colon + 1;
+            while (*value == ' ') value++;
+
+            if (strcmp(s, "Id") == 0) snprintf(req->id, sizeof(req->id), "%s", value);
+            else if (strcmp(s, "Path") == 0) snprintf(req->path, sizeof(req->path), "%s", value);
+            else if (strcmp(s, "Name") == 0) snprintf(req->name, sizeof(req->name), "%s", value);
+            else if (strcmp(s, "Verbose") == 0) req->verbose = atoi(value);
+            else if (strcmp(s, "Color") == 0) req->color = atoi(value);
+            else if (strcmp(s, "Reload") == 0) req->reload = atoi(value);
+            else if (strcmp(s, "Export") == 0) {
+                snprintf(req->format_name, sizeof(req->format_name), "%s", value);
+                req->export = export_format(value, &req->format) ? 1 : -1;
+            }
+        }
+        s = next;
+    }
+
+    req->body = s;
+    req->body_len = (size_t) (end - s);
+}
+
+// Remove ANSI color sequences in place
+static void strip_colors(Output *out) {
+    size_t w = 0;
+    for (size_t r = 0; r < out->len; r++) {
+        if (out->data[r] == '\033' && r + 1 < out->len && out->data[r + 1] == '[') {
+            r += 2;
+            while (r < out->len && (out->data[r] < '@' || out->data[r] > '~')) r++;
+            continue;
+        }
+        out->data[w++] = out->data[r];
+    }
+    out->len = w;
+}
+
+// Import cache for a request (a Reload starts a fresh one). The caller releases it
+static ModuleCache *request_modules(Server *srv, const int reload) {
+    pool_lock(srv->cache_lock);
+    if (reload || !srv->modules) {
+        ModuleCache *fresh = module_cache_new();
+        if (fresh) {
+            // Running requests still own the old cache, the last one frees it
+            module_cache_release(srv->modules);
+            srv->modules = fresh;
+        }
+    }
+    ModuleCache *modules = module_cache_retain(srv->modules);
+    pool_unlock(srv->cache_lock);
+    return modules;
+}
+
+// Compile one request into diag (and the export into artifact), return the error count
+static int handle_request(Server *srv, const Request *req, Output *diag, Output *artifact) {
+    if (req->export < 0) {
+        out_printf(diag, "\033[1;31mError:\033[0m unknown export format '%s' (use json, csv or ndjson)\n",
+                   req->format_name);
+        return 1;
+    }
+
+    Exporter e;
+    if (req->export) export_begin(&e, artifact, req->format);
+
+    ModuleCache *modules = request_modules(srv, req->reload);
+    const CompileOptions opt = {req->verbose, diag, NULL, modules, req->export ? export_line : NULL, &e};
+    int error;
+
+    if (!req->path[0]) {
+        error = compile_source(req->name, req->body, req->body_len, &opt);
+    } else {
+        size_t len = 0;
+        char *src = read_source(req->path, &len);
+        if (!src) {
+            out_printf(diag, "\033[1;31mError:\033[0m cannot open file %s. Does it exist?\n", req->path);
+            artifact->len = 0;
+            module_cache_release(modules);
+            return 1;
+        }
+        error = compile_source(req->path, src, len, &opt);
+        free(src);
+    }
+
+    if (req->export) export_end(&e);
+    module_cache_release(modules);
+    return error;
+}
+
+static void write_response(Server *srv, const char *id, const int error, const Output *diag, const Output *artifact) {
+    char head[512];
+    const int head_len = snprintf(head, sizeof(head),
+                                  "Id: %s\nStatus: %s\nErrors: %d\nDiagnostics: %lu\nArtifact: %lu\n\n",
+                                  id, error ? "error" : "ok", error, (unsigned long) diag->len,
+                                  (unsigned long) artifact->len);
+
+    pool_lock(srv->out_lock);
+    printf("%lu\n", (unsigned long) ((size_t) head_len + diag->len + artifact->len));
+    fwrite(head, 1, (size_t) head_len, stdout);
+    if (diag->len) fwrite(diag->data, 1, diag->len, stdout);
+    if (artifact->len) fwrite(artifact->data, 1, artifact->len, stdout);
+    fflush(stdout);
+    pool_unlock(srv->out_lock);
+}
+
+// Worker: take turns reading requests, compile them concurrently
+static void serve(const int index, void *ctx) {
+    Server *srv = ctx;
+    (void) index;
+
+    // Buffers are reused between requests
+    char *frame = NULL;
+    size_t frame_cap = 0, frame_len = 0;
+    Output diag, artifact;
+    out_init_memory(&diag);
+    out_init_memory(&artifact);
+
+    for (;;) {
+        pool_lock(srv->in_lock);
+        const int got = srv->done ? 0 : read_frame(&frame, &frame_cap, &frame_len);
+        if (got <= 0) srv->done = 1;
+        pool_unlock(srv->in_lock);
+
+        if (got < 0) {
+            // Framing is lost: report it and stop reading
+            diag.len = artifact.len = 0;
+            out_printf(&diag, "Error: malformed request frame\n");
+            write_response(srv, "", 1, &diag, &artifact);
+        }
+        if (got <= 0) break;
+
+        Request req;
+        parse_request(frame, frame_len, &req);
+
+        diag.len = artifact.len = 0;
+        const int error = handle_request(srv, &req, &diag, &artifact);
+        if (!req.color) strip_colors(&diag);
+        write_response(srv, req.id, error, &diag, &artifact);
+    }
+
+    free(frame);
+    out_free(&diag);
+    out_free(&artifact);
+}
+
+int run_server(const int jobs) {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    Server srv;
+    memset(&srv, 0, sizeof(srv));
+    srv.in_lock = pool_mutex_new();
+    srv.out_lock = pool_mutex_new();
+    srv.cache_lock = pool_mutex_new();
+    if (!srv.in_lock || !srv.out_lock || !srv.cache_lock) {
+        fprintf(stderr, "\033[1;31mError:\033[0m cannot start server\n");
+        return 1;
+    }
+
+    const int threads = jobs > 0 ? jobs : pool_cpu_count();
+    pool_run(threads, threads, serve, &srv);
+
+    module_cache_release(srv.modules);
+    pool_mutex_free(srv.in_lock);
+    pool_mutex_free(srv.out_lock);
+    pool_mutex_free(srv.cache_lock);
+    return 0;
+}
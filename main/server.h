@@ -0,0 +1,25 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+// Compile server over stdin/stdout.
+//
+// Every message is a frame: the payload length in decimal, a newline, then the payload.
+// A payload is "Key: value" header lines, an empty line and an optional body.
+//
+// Request headers:
+//   Id: <text>        echoed back in the response
+//   Path: <file.ds>   file to compile (or send the source as the body)
+//   Name: <file.ds>   name of an inline source, used for diagnostics and imports
+//   Verbose: 1        verbose diagnostics
+//   Color: 1          keep ANSI colors in diagnostics
+//   Reload: 1         forget cached imports before compiling (changed files are re-read anyway)
+//   Export: <format>  return the dialog lines as json, csv or ndjson (the artifact);
+//                     any other format fails the request
+//
+// Response headers: Id, Status (ok or error), Errors, Diagnostics and Artifact
+// (byte counts); the body is the diagnostics followed by the artifact.
+// Requests run concurrently, so responses may come back in any order.
+int run_server(int jobs);
@@ -0,0 +1,237 @@
+// Copyright © 2025 Arsenii Motorin
+// Licensed under the Apache License, Version 2.0
+// See: http://www.apache.org/licenses/LICENSE-2.0
+
+// Stand-in client for `dialscript --server` (POSIX only).
+// Sends framed requests for the given files and measures requests per second.
+//
+// Usage: dialscript-client [options] <file.ds>...
+//   --server=PATH    dialscript binary (default: ./dialscript)
+//   --requests=N     number of requests, files are cycled (default: 1000)
+//   --jobs=N         server worker threads (default: all CPUs)
+//   --inline         send sources in the request body instead of paths
+//   --print          print every response
+//   --spawn          also time one `dialscript <file>` process per request
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+// Client settings
+typedef struct {
+    const char *server;
+    int requests;
+    int jobs;
+    int inline_source;
+    int print;
+    int spawn;
+    char **files;
+    int file_count;
+    char **sources;         // File contents for --inline
+    size_t *source_lens;
+    FILE *to_server;
+} Client;
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
+}
+
+static char *read_all(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    size_t cap = 4096, n = 0, got;
+    char *buf = malloc(cap);
+    while (buf && (got = fread(buf + n, 1, cap - n, f)) > 0) {
+        n += got;
+        if (n == cap) {
+            char *grown = realloc(buf, cap *= 2);
+            if (!grown) free(buf);
+            buf = grown;
+        }
+    }
+    fclose(f);
+    *len = n;
+    return buf;
+}
+
+// Writer thread: send every request, then close the server's input
+static void *send_requests(void *arg) {
+    const Client *c = arg;
+    char head[2048];
+
+    for (int i = 0; i < c->requests; i++) {
+        const int f = i % c->file_count;
+        int head_len;
+        size_t body_len = 0;
+
+        if (c->inline_source) {
+            head_len = snprintf(head, sizeof(head), "Id: %d\nName: %s\n\n", i, c->files[f]);
+            body_len = c->source_lens[f];
+        } else {
+            head_len = snprintf(head, sizeof(head), "Id: %d\nPath: %s\n\n", i, c->files[f]);
+        }
+
+        fprintf(c->to_server, "%lu\n", (unsigned long) ((size_t) head_len + body_len));
+        fwrite(head, 1, (size_t) head_len, c->to_server);
+        if (body_len) fwrite(c->sources[f], 1, body_len, c->to_server);
+    }
+
+    fclose(c->to_server);
+    return NULL;
+}
+
+// Read one response frame, return its Errors value (-1 at end of input)
+static int read_response(FILE *from, const int print, char **buf, size_t *cap) {
+    unsigned long len;
+    if (fscanf(from, "%lu", &len) != 1 || fgetc(from) != '\n') return -1;
+    if (len + 1 > *cap) {
+        char *grown = realloc(*buf, len + 1);
+        if (!grown) return -1;
+        *buf = grown;
+        *cap = len + 1;
+    }
+    if (fread(*buf, 1, len, from) != len) return -1;
+    (*buf)[len] = '\0';
+
+    if (print) fwrite(*buf, 1, len, stdout);
+    const char *errors = strstr(*buf, "\nErrors: ");
+    return errors ? atoi(errors + 9) : 0;
+}
+
+// Time the persistent server
+static int bench_server(Client *c) {
+    int to_server[2], from_server[2];
+    if (pipe(to_server) != 0 || pipe(from_server) != 0) {
+        perror("pipe");
+        return 1;
+    }
+
+    char jobs[32];
+    snprintf(jobs, sizeof(jobs), "--jobs=%d", c->jobs);
+
+    const double start = now();
+    const pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return 1;
+    }
+    if (pid == 0) {
+        dup2(to_server[0], STDIN_FILENO);
+        dup2(from_server[1], STDOUT_FILENO);
+        close(to_server[0]);
+        close(to_server[1]);
+        close(from_server[0]);
+        close(from_server[1]);
+        execl(c->server, c->server, "--server", jobs, (char *) NULL);
+        perror("exec");
+        _exit(127);
+    }
+
+    close(to_server[0]);
+    close(from_server[1]);
+    c->to_server = fdopen(to_server[1], "wb");
+    FILE *from = fdopen(from_server[0], "rb");
+
+    pthread_t writer;
+    pthread_create(&writer, NULL, send_requests, c);
+
+    char *buf = NULL;
+    size_t cap = 0;
+    int received = 0, failed = 0, errors;
+    while ((errors = read_response(from, c->print, &buf, &cap)) >= 0) {
+        received++;
+        if (errors) failed++;
+    }
+    const double elapsed = now() - start;
+
+    pthread_join(writer, NULL);
+    fclose(from);
+    free(buf);
+    waitpid(pid, NULL, 0);
+
+    printf("server: %d requests in %.3f s (%.0f req/s), %d with errors\n", received, elapsed,
+           received / elapsed, failed);
+    return received == c->requests ? 0 : 1;
+}
+
+// Time one process per request, the way tools call dialscript today
+static int bench_spawn(const Client *c) {
+    const double start = now();
+    int failed = 0;
+
+    for (int i = 0; i < c->requests; i++) {
+        const pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            return 1;
+        }
+        if (pid == 0) {
+            const int devnull = open("/dev/null", O_WRONLY);
+            if (devnull >= 0) dup2(devnull, STDOUT_FILENO);
+            execl(c->server, c->server, c->files[i % c->file_count], (char *) NULL);
+            _exit(127);
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) failed++;
+    }
+
+    const double elapsed = now() - start;
+    printf("spawn:  %d requests in %.3f s (%.0f req/s), %d with errors\n", c->requests, elapsed,
+           c->requests / elapsed, failed);
+    return 0;
+}
+
+int main(const int argc, char *argv[]) {
+    Client c = {"./dialscript", 1000, 0, 0, 0, 0, NULL, 0, NULL, NULL, NULL};
+    c.files = malloc(sizeof(char *) * (size_t) argc);
+    if (!c.files) return 1;
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--server=", 9) == 0) c.server = argv[i] + 9;
+        else if (strncmp(argv[i], "--requests=", 11) == 0) c.requests = atoi(argv[i] + 11);
+        else if (strncmp(argv[i], "--jobs=", 7) == 0) c.jobs = atoi(argv[i] + 7);
+        else if (strcmp(argv[i], "--inline") == 0) c.inline_source = 1;
+        else if (strcmp(argv[i], "--print") == 0) c.print = 1;
+        else if (strcmp(argv[i], "--spawn") == 0) c.spawn = 1;
+        else if (argv[i][0] != '-') c.files[c.file_count++] = argv[i];
+        else {
+            fprintf(stderr, "Unknown option '%s'\n", argv[i]);
+            return 1;
+        }
+    }
+
+    if (!c.file_count || c.requests <= 0) {
+        fprintf(stderr, "Usage: dialscript-client [--server=PATH] [--requests=N] [--jobs=N] "
+                        "[--inline] [--print] [--spawn] <file.ds>...\n");
+        return 1;
+    }
+
+    if (c.inline_source) {
+        c.sources = calloc((size_t) c.file_count, sizeof(char *));
+        c.source_lens = calloc((size_t) c.file_count, sizeof(size_t));
+        for (int i = 0; c.sources && c.source_lens && i < c.file_count; i++) {
+            c.sources[i] = read_all(c.files[i], &c.source_lens[i]);
+            if (!c.sources[i]) {
+                fprintf(stderr, "Cannot read %s\n", c.files[i]);
+                return 1;
+            }
+        }
+    }
+
+    int result = bench_server(&c);
+    if (c.spawn) result |= bench_spawn(&c);
+
+    for (int i = 0; c.sources && i < c.file_count; i++) free(c.sources[i]);
+    free(c.sources);
+    free(c.source_lens);
+    free(c.files);
+    return result;
+}